@@ -1,9 +1,12 @@
 #include "bench_common.hpp"
 #include "sha3_224.hpp"
 #include "sha3_256.hpp"
+#include "sha3_256_many.hpp"
 #include "sha3_384.hpp"
 #include "sha3_512.hpp"
+#include <array>
 #include <benchmark/benchmark.h>
+#include <vector>
 
 // Benchmarks SHA3-224 hash function with variable length input message.
 void
@@ -133,6 +136,137 @@ bench_sha3_512(benchmark::State& state)
 #endif
 }
 
+// Benchmarks one-shot hashing, using free function `hash` of one of SHA3-{224,
+// 256, 384, 512}, with variable length input message, which is, mostly, short
+// enough to take the single block fast path.
+template<size_t digest_len,
+         void (*hash)(std::span<const uint8_t>, std::span<uint8_t, digest_len>)>
+void
+bench_sha3_oneshot(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range());
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> md(digest_len);
+  auto _md = std::span<uint8_t, digest_len>(md);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    hash(msg, _md);
+
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(_md);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + md.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks one-shot hashing, using free function `hash` of one of SHA3-{224,
+// 256, 384, 512}, specialized for input message of `mlen` -bytes, as known at
+// compile-time, compare with `sha3_*_hash` benchmark, hashing same length
+// input message, of length known only at runtime.
+template<size_t digest_len,
+         size_t mlen,
+         void (*hash)(std::span<const uint8_t, mlen>,
+                      std::span<uint8_t, digest_len>)>
+void
+bench_sha3_fixed(benchmark::State& state)
+{
+  std::array<uint8_t, mlen> msg{};
+  std::array<uint8_t, digest_len> md{};
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    hash(msg, md);
+
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(md);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + md.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Computes SHA3-256 digest of each of many messages, one after another, as
+// baseline for `sha3_256::hash_many`.
+static void
+sha3_256_hash_each(std::span<const std::span<const uint8_t>> msgs,
+                   std::span<uint8_t> mds)
+{
+  constexpr size_t dlen = sha3_256::DIGEST_LEN;
+
+  for (size_t i = 0; i < msgs.size(); i++) {
+    sha3_256::hash(msgs[i], mds.subspan(i * dlen).first<dlen>());
+  }
+}
+
+// Benchmarks SHA3-256 hashing of variable number of messages, using given
+// routine, with message lengths drawn from one of following distributions
+//
+// - 0 : all messages are 64 -bytes
+// - 1 : uniformly random, in [0, 512) -bytes
+// - 2 : seven of every eight messages are 32 -bytes, remaining are 4096 -bytes
+//
+// Processed items are messages, so that messages/ second can be compared.
+template<void (*hash_many)(std::span<const std::span<const uint8_t>>,
+                           std::span<uint8_t>)>
+void
+bench_sha3_256_hash_many(benchmark::State& state)
+{
+  const size_t cnt = static_cast<size_t>(state.range(0));
+  const size_t dist = static_cast<size_t>(state.range(1));
+
+  std::vector<uint16_t> mlens(cnt);
+  sha3_utils::random_data<uint16_t>(mlens);
+
+  std::vector<std::vector<uint8_t>> msgs(cnt);
+  std::vector<std::span<const uint8_t>> _msgs(cnt);
+  std::vector<uint8_t> mds(cnt * sha3_256::DIGEST_LEN);
+
+  size_t mlen_sum = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    const size_t mlen = (dist == 0)   ? 64
+                        : (dist == 1) ? (mlens[i] % 512)
+                        : (i % 8 == 7) ? 4096
+                                       : 32;
+
+    msgs[i].resize(mlen);
+    sha3_utils::random_data<uint8_t>(msgs[i]);
+    _msgs[i] = msgs[i];
+
+    mlen_sum += mlen;
+  }
+
+  for (auto _ : state) {
+    hash_many(_msgs, mds);
+
+    benchmark::DoNotOptimize(_msgs);
+    benchmark::DoNotOptimize(mds);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (mlen_sum + mds.size());
+  state.SetBytesProcessed(bytes_processed);
+  state.SetItemsProcessed(state.iterations() * cnt);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
 BENCHMARK(bench_sha3_224)
   ->RangeMultiplier(4)
   ->Range(64, 16384)
@@ -157,3 +291,81 @@ BENCHMARK(bench_sha3_512)
   ->Name("sha3_512")
   ->ComputeStatistics("min", compute_min)
   ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_224)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_224")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_224::DIGEST_LEN, sha3_224::hash>)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_224_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_256")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_256::DIGEST_LEN, sha3_256::hash>)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_256_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_384)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_384")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_384::DIGEST_LEN, sha3_384::hash>)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_384_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_512)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_512")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_512::DIGEST_LEN, sha3_512::hash>)
+  ->DenseRange(0, 256, 32)
+  ->Name("sha3_512_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_256::DIGEST_LEN, sha3_256::hash>)
+  ->Arg(32)
+  ->Arg(1184)
+  ->Name("sha3_256_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_fixed<sha3_256::DIGEST_LEN, 32, sha3_256::hash<32>>)
+  ->Name("sha3_256_hash<32>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_fixed<sha3_256::DIGEST_LEN, 1184, sha3_256::hash<1184>>)
+  ->Name("sha3_256_hash<1184>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_oneshot<sha3_512::DIGEST_LEN, sha3_512::hash>)
+  ->Arg(33)
+  ->Arg(64)
+  ->Name("sha3_512_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_fixed<sha3_512::DIGEST_LEN, 33, sha3_512::hash<33>>)
+  ->Name("sha3_512_hash<33>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_fixed<sha3_512::DIGEST_LEN, 64, sha3_512::hash<64>>)
+  ->Name("sha3_512_hash<64>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256_hash_many<sha3_256_hash_each>)
+  ->ArgsProduct({ { 1, 4, 8, 16, 64, 256 }, { 0, 1, 2 } })
+  ->Name("sha3_256_hash_each")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256_hash_many<sha3_256::hash_many>)
+  ->ArgsProduct({ { 1, 4, 8, 16, 64, 256 }, { 0, 1, 2 } })
+  ->Name("sha3_256_hash_many")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
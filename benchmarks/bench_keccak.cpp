@@ -1,9 +1,19 @@
 #include "bench_common.hpp"
 #include "keccak.hpp"
+#include "keccak_x2.hpp"
+#include "keccak_x4.hpp"
+#include "keccak_x5.hpp"
+#include "keccak_x8.hpp"
+#include "keccak_xn.hpp"
 #include "utils.hpp"
+#include <array>
 #include <benchmark/benchmark.h>
+#include <string>
+#include <utility>
 
-// Benchmarks Keccak-p[1600, 24] permutation.
+// Benchmarks Keccak-p[1600, nr] permutation, labelled with name of the kernel
+// used by `keccak::permute`.
+template<size_t rounds>
 void
 bench_keccak_permutation(benchmark::State& state)
 {
@@ -11,7 +21,7 @@ bench_keccak_permutation(benchmark::State& state)
   sha3_utils::random_data<uint64_t>(st);
 
   for (auto _ : state) {
-    keccak::permute(st);
+    keccak::permute<rounds>(st);
 
     benchmark::DoNotOptimize(st);
     benchmark::ClobberMemory();
@@ -19,13 +29,370 @@ bench_keccak_permutation(benchmark::State& state)
 
   const size_t bytes_processed = state.iterations() * sizeof(st);
   state.SetBytesProcessed(bytes_processed);
+  state.SetLabel(std::string(keccak::permute_kernel_name()));
 
 #ifdef CYCLES_PER_BYTE
   state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
 #endif
 }
 
-BENCHMARK(bench_keccak_permutation)
+// Benchmarks Keccak-p[1600, 24] permutation, using given single-state kernel,
+// so that all kernels can be compared on same target, irrespective of which
+// one is selected for `keccak::permute`.
+template<void (*permute)(uint64_t*)>
+void
+bench_keccak_permutation_kernel(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    permute(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+#if defined KECCAK_X86_64
+
+// Benchmarks single-state AVX2 Keccak-p[1600, 24] permutation kernel, which is
+// compiled in on every x86_64 target, but is skipped when the CPU, running the
+// benchmark, doesn't support AVX2.
+void
+bench_keccak_permutation_avx2(benchmark::State& state)
+{
+  if (!keccak::cpu_features().avx2) {
+    state.SkipWithError("CPU doesn't support AVX2");
+    return;
+  }
+
+  bench_keccak_permutation_kernel<keccak::permute_avx2>(state);
+}
+
+#endif
+
+// Stand-in for caller's hot code, which runs in between permutations, in a
+// mixed workload, doing a pass of multiply-accumulate, reduced modulo Kyber's
+// q, over 64 polynomial coefficients. Each instantiation uses a distinct
+// constant, so that none of them can be folded into another, and the loop is
+// unrolled, so that together they take up a sizable part of instruction cache,
+// while running only a few cycles each.
+template<size_t i>
+[[gnu::noinline]] static void
+mix_poly(uint16_t* const poly)
+{
+  constexpr uint32_t q = 3329;
+  constexpr uint32_t zeta = (17 * (i + 1)) % q;
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 64
+#endif
+  for (size_t j = 0; j < 64; j++) {
+    poly[j] = static_cast<uint16_t>((poly[j] * zeta + j) % q);
+  }
+}
+
+template<size_t... i>
+static constexpr auto
+mix_poly_table(std::index_sequence<i...>)
+{
+  return std::array<void (*)(uint16_t*), sizeof...(i)>{ mix_poly<i>... };
+}
+
+// Distinct pieces of caller's hot code, to be run in between permutations.
+static constexpr auto MIX_POLY = mix_poly_table(std::make_index_sequence<16>{});
+
+// Benchmarks end-to-end latency of a mixed loop, where each iteration runs
+// variable number of pieces of caller's hot code, polluting instruction cache,
+// before applying Keccak-p[1600, 24] permutation, using given single-state
+// kernel. Unlike isolated permutation benchmarks, the kernel competes with
+// caller's code for instruction cache, so kernels with large, unrolled, body
+// evict caller's code and get evicted by it.
+template<void (*permute)(uint64_t*)>
+void
+bench_keccak_permutation_mixed(benchmark::State& state)
+{
+  const size_t cnt = static_cast<size_t>(state.range(0));
+
+  uint64_t st[keccak::LANE_CNT]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  std::array<uint16_t, 64> poly{};
+  sha3_utils::random_data<uint16_t>(poly);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < cnt; i++) {
+      MIX_POLY[i](poly.data());
+    }
+
+    permute(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::DoNotOptimize(poly);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Applies `keccak::permute_roundx4` on each of two lane-interleaved states, one
+// after another. It's the baseline for `keccak::permute_x2_scalar`, which
+// applies same round function, interleaving both states within each step.
+static void
+permute_x2_roundx4(uint64_t* const state)
+{
+  uint64_t s0[keccak::LANE_CNT], s1[keccak::LANE_CNT];
+
+  for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+    s0[i] = state[i * keccak::X2_WAYS + 0];
+    s1[i] = state[i * keccak::X2_WAYS + 1];
+  }
+
+  keccak::permute_roundx4(s0);
+  keccak::permute_roundx4(s1);
+
+  for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+    state[i * keccak::X2_WAYS + 0] = s0[i];
+    state[i * keccak::X2_WAYS + 1] = s1[i];
+  }
+}
+
+// Benchmarks 2-way batched Keccak-p[1600, 24] permutation, using given kernel.
+// Processed bytes account for both states, so that cycles/ byte is comparable
+// with the scalar permutation.
+template<void (*permute)(uint64_t*)>
+void
+bench_keccak_permutation_x2(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT * keccak::X2_WAYS]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    permute(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks 4-way batched Keccak-p[1600, 24] permutation. Processed bytes
+// account for all four states, so that cycles/ byte is comparable with the
+// scalar permutation, while processed items count permutations.
+void
+bench_keccak_permutation_x4(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT * keccak::X4_WAYS]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    keccak::permute_x4(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+  state.SetItemsProcessed(state.iterations() * keccak::X4_WAYS);
+  state.SetLabel(std::string(keccak::permute_x4_kernel_name()));
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks 5-way batched Keccak-p[1600, 24] permutation, using given
+// kernel. Processed items count permutations, so that aggregate permutations
+// per second can be compared with the pure SIMD 4-way kernel.
+template<void (*permute)(uint64_t*)>
+void
+bench_keccak_permutation_x5(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT * keccak::X5_WAYS]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    permute(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+  state.SetItemsProcessed(state.iterations() * keccak::X5_WAYS);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks 8-way batched Keccak-p[1600, 24] permutation. Processed bytes
+// account for all eight states, so that cycles/ byte is comparable with the
+// scalar permutation.
+void
+bench_keccak_permutation_x8(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT * keccak::X8_WAYS]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    keccak::permute_x8(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+  state.SetLabel(std::string(keccak::permute_x8_kernel_name()));
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks N-way batched Keccak-p[1600, 24] permutation, written using
+// generic vector extensions, so that it can be compared against hand-written
+// kernels, permuting same # -of states. Processed bytes account for all states.
+template<size_t ways>
+void
+bench_keccak_permutation_xN(benchmark::State& state)
+{
+  uint64_t st[keccak::LANE_CNT * ways]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    keccak::permute_xN<ways>(st);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * sizeof(st);
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+BENCHMARK(bench_keccak_permutation<keccak::ROUNDS>)
   ->Name("keccak-p[1600, 24]")
   ->ComputeStatistics("min", compute_min)
   ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation<12>)
+  ->Name("keccak-p[1600, 12]")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_kernel<keccak::permute_roundx2>)
+  ->Name("keccak-p[1600, 24] roundx2")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_kernel<keccak::permute_roundx4>)
+  ->Name("keccak-p[1600, 24] roundx4")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_kernel<keccak::permute_lc>)
+  ->Name("keccak-p[1600, 24] lc")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_kernel<keccak::permute_compact>)
+  ->Name("keccak-p[1600, 24] compact")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_mixed<keccak::permute_roundx2>)
+  ->Arg(0)
+  ->Arg(8)
+  ->Arg(12)
+  ->Arg(16)
+  ->Name("keccak-p[1600, 24] roundx2 mixed")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_mixed<keccak::permute_roundx4>)
+  ->Arg(0)
+  ->Arg(8)
+  ->Arg(12)
+  ->Arg(16)
+  ->Name("keccak-p[1600, 24] roundx4 mixed")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_mixed<keccak::permute_lc>)
+  ->Arg(0)
+  ->Arg(8)
+  ->Arg(12)
+  ->Arg(16)
+  ->Name("keccak-p[1600, 24] lc mixed")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_mixed<keccak::permute_compact>)
+  ->Arg(0)
+  ->Arg(8)
+  ->Arg(12)
+  ->Arg(16)
+  ->Name("keccak-p[1600, 24] compact mixed")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+#if defined KECCAK_X86_64
+BENCHMARK(bench_keccak_permutation_avx2)
+  ->Name("keccak-p[1600, 24] avx2")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+#endif
+BENCHMARK(bench_keccak_permutation_x2<keccak::permute_x2>)
+  ->Name("keccak-p[1600, 24] x2")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x2<keccak::permute_x2_scalar>)
+  ->Name("keccak-p[1600, 24] x2 scalar")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x2<permute_x2_roundx4>)
+  ->Name("keccak-p[1600, 24] x2 sequential")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_xN<2>)
+  ->Name("keccak-p[1600, 24] xN<2>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x4)
+  ->Name("keccak-p[1600, 24] x4")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_xN<4>)
+  ->Name("keccak-p[1600, 24] xN<4>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x5<keccak::permute_x5>)
+  ->Name("keccak-p[1600, 24] x5")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x5<keccak::permute_x5_scalar>)
+  ->Name("keccak-p[1600, 24] x5 sequential")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_x8)
+  ->Name("keccak-p[1600, 24] x8")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_keccak_permutation_xN<8>)
+  ->Name("keccak-p[1600, 24] xN<8>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
@@ -0,0 +1,292 @@
+#include "bench_common.hpp"
+#include "sha3_224.hpp"
+#include "sha3_256.hpp"
+#include "sha3_384.hpp"
+#include "sha3_512.hpp"
+#include "shake128.hpp"
+#include "sponge.hpp"
+#include "turboshake128.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Benchmarks absorption of variable length input into Keccak[c] sponge of
+// given rate, using Keccak-p[1600, nr] permutation, in a single call to
+// `sponge::absorb`, s.t. all but the partially filled last block are absorbed
+// straight from the input, by `sponge::absorb_blocks`.
+template<size_t rate, size_t rounds>
+void
+bench_sponge_absorb(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+
+  std::vector<uint8_t> msg(mlen);
+  sha3_utils::random_data<uint8_t>(msg);
+
+  uint64_t st[keccak::LANE_CNT]{};
+  size_t offset = 0;
+
+  for (auto _ : state) {
+    sponge::absorb<rate, rounds>(st, offset, msg);
+
+    benchmark::DoNotOptimize(st);
+    benchmark::DoNotOptimize(offset);
+    benchmark::DoNotOptimize(msg);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * msg.size();
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks incremental absorption of fixed length input into SHA3-256
+// hasher, in pieces of variable, but small, byte length, as produced by
+// parsers, which feed the hasher a few bytes at a time.
+void
+bench_sponge_absorb_incremental(benchmark::State& state)
+{
+  const size_t clen = static_cast<size_t>(state.range(0));
+  constexpr size_t mlen = 4096;
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> md(sha3_256::DIGEST_LEN);
+
+  auto _msg = std::span(msg);
+  auto _md = std::span<uint8_t, sha3_256::DIGEST_LEN>(md);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    sha3_256::sha3_256_t hasher;
+
+    size_t off = 0;
+    while (off < mlen) {
+      const size_t elen = std::min(clen, mlen - off);
+
+      hasher.absorb(_msg.subspan(off, elen));
+      off += elen;
+    }
+
+    hasher.finalize();
+    hasher.digest(_md);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(md);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * msg.size();
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks squeezing of eight blocks worth of output bytes, out of a
+// finalized Keccak[c] sponge of given rate, in pieces of variable byte length,
+// ranging from a single byte to multiple blocks.
+template<size_t rate>
+void
+bench_sponge_squeeze(benchmark::State& state)
+{
+  const size_t clen = static_cast<size_t>(state.range(0));
+  constexpr size_t olen = (rate / 8) * 8;
+
+  std::vector<uint8_t> out(olen);
+  auto _out = std::span(out);
+
+  uint64_t st[keccak::LANE_CNT]{};
+  sha3_utils::random_data<uint64_t>(st);
+
+  for (auto _ : state) {
+    size_t squeezable = rate / 8;
+
+    size_t off = 0;
+    while (off < olen) {
+      const size_t elen = std::min(clen, olen - off);
+
+      sponge::squeeze<rate>(st, squeezable, _out.subspan(off, elen));
+      off += elen;
+    }
+
+    benchmark::DoNotOptimize(st);
+    benchmark::DoNotOptimize(squeezable);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * out.size();
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Absorbs message fragments into SHA3-256 hasher, in a single call.
+static void
+absorb_fragmented(sha3_256::sha3_256_t& hasher,
+                  std::span<const std::span<const uint8_t>> frags,
+                  std::span<uint8_t>)
+{
+  hasher.absorb(frags);
+}
+
+// Absorbs message fragments into SHA3-256 hasher, one call per fragment.
+static void
+absorb_each_fragment(sha3_256::sha3_256_t& hasher,
+                     std::span<const std::span<const uint8_t>> frags,
+                     std::span<uint8_t>)
+{
+  for (const auto frag : frags) {
+    hasher.absorb(frag);
+  }
+}
+
+// Copies message fragments, one after another, into `buf`, which is then
+// absorbed into SHA3-256 hasher.
+static void
+absorb_concatenated(sha3_256::sha3_256_t& hasher,
+                    std::span<const std::span<const uint8_t>> frags,
+                    std::span<uint8_t> buf)
+{
+  size_t off = 0;
+  for (const auto frag : frags) {
+    std::copy(frag.begin(), frag.end(), buf.subspan(off).begin());
+    off += frag.size();
+  }
+
+  hasher.absorb(buf.first(off));
+}
+
+// Benchmarks SHA3-256 hashing of variable length message, split into variable
+// number of fragments of uneven length, using given absorption strategy.
+template<void (*absorb)(sha3_256::sha3_256_t&,
+                        std::span<const std::span<const uint8_t>>,
+                        std::span<uint8_t>)>
+void
+bench_sha3_256_fragments(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t cnt = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> buf(mlen);
+  std::vector<uint8_t> md(sha3_256::DIGEST_LEN);
+
+  auto _msg = std::span(msg);
+  auto _md = std::span<uint8_t, sha3_256::DIGEST_LEN>(md);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  // Fragment boundaries, at random positions
+  std::vector<uint32_t> cuts(cnt - 1);
+  sha3_utils::random_data<uint32_t>(cuts);
+
+  for (auto& cut : cuts) {
+    cut %= static_cast<uint32_t>(mlen + 1);
+  }
+  std::sort(cuts.begin(), cuts.end());
+  cuts.push_back(static_cast<uint32_t>(mlen));
+
+  std::vector<std::span<const uint8_t>> frags;
+
+  size_t off = 0;
+  for (const size_t cut : cuts) {
+    frags.push_back(_msg.subspan(off, cut - off));
+    off = cut;
+  }
+
+  for (auto _ : state) {
+    sha3_256::sha3_256_t hasher;
+
+    absorb(hasher, frags, buf);
+    hasher.finalize();
+    hasher.digest(_md);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(buf);
+    benchmark::DoNotOptimize(md);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * msg.size();
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+BENCHMARK(bench_sponge_absorb<shake128::RATE, keccak::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<1344, 24>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb<sha3_256::RATE, keccak::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<1088, 24>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb<sha3_224::RATE, keccak::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<1152, 24>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb<sha3_384::RATE, keccak::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<832, 24>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb<sha3_512::RATE, keccak::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<576, 24>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb<turboshake128::RATE, turboshake128::ROUNDS>)
+  ->RangeMultiplier(4)
+  ->Range(1 << 10, 1 << 24)
+  ->Name("sponge_absorb<1344, 12>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_absorb_incremental)
+  ->RangeMultiplier(2)
+  ->Range(1, 256)
+  ->Name("sponge_absorb_incremental")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sponge_squeeze<shake128::RATE>)
+  ->Arg(1)
+  ->Arg(32)
+  ->Arg(shake128::RATE / 8)
+  ->Arg(shake128::RATE)
+  ->Name("sponge_squeeze<1344>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256_fragments<absorb_fragmented>)
+  ->ArgsProduct({ { 256, 1500, 16384 }, { 4, 16, 64 } })
+  ->Name("sha3_256_absorb_fragmented")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256_fragments<absorb_each_fragment>)
+  ->ArgsProduct({ { 256, 1500, 16384 }, { 4, 16, 64 } })
+  ->Name("sha3_256_absorb_each_fragment")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_sha3_256_fragments<absorb_concatenated>)
+  ->ArgsProduct({ { 256, 1500, 16384 }, { 4, 16, 64 } })
+  ->Name("sha3_256_absorb_concatenated")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
@@ -1,7 +1,15 @@
 #include "bench_common.hpp"
+#include "kangarootwelve.hpp"
+#include "parallelhash.hpp"
 #include "shake128.hpp"
+#include "shake128x4.hpp"
 #include "shake256.hpp"
+#include "shake256x4.hpp"
+#include "turboshake128.hpp"
+#include "turboshake256.hpp"
+#include <array>
 #include <benchmark/benchmark.h>
+#include <thread>
 
 // Benchmarks SHAKE-128 extendable output function with variable length input
 // and squeezed output.
@@ -75,6 +83,386 @@ bench_shake256(benchmark::State& state)
 #endif
 }
 
+// Benchmarks TurboSHAKE-128 extendable output function with variable length
+// input and squeezed output, using default domain separation byte.
+//
+// Note, all input bytes are absorbed in a single call to `absorb` function.
+// And all output bytes are squeezed in a single call to `squeeze` function.
+void
+bench_turboshake128(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t olen = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    turboshake128::turboshake128_t hasher;
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.squeeze(out);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks TurboSHAKE-256 extendable output function with variable length
+// input and squeezed output, using default domain separation byte.
+//
+// Note, all input bytes are absorbed in a single call to `absorb` function.
+// And all output bytes are squeezed in a single call to `squeeze` function.
+void
+bench_turboshake256(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t olen = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    turboshake256::turboshake256_t hasher;
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.squeeze(out);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks KangarooTwelve extendable output function with variable length
+// input, hashing leaves using variable number of worker threads, while
+// squeezing fixed length output.
+//
+// Note, as leaves are hashed by worker threads, throughput is computed using
+// wall clock time.
+void
+bench_kangarootwelve(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t threads = static_cast<size_t>(state.range(1));
+  constexpr size_t olen = 64;
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    kangarootwelve::kangarootwelve_t hasher(threads);
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.squeeze(out);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks KangarooTwelve, absorbing 16 MiB input in chunks of variable
+// length, using variable number of worker threads, while squeezing fixed
+// length output. Hasher is created once and reset after each iteration, so
+// that its worker threads are spawned only once, as done by streaming callers.
+//
+// Note, as leaves are hashed by worker threads, throughput is computed using
+// wall clock time.
+void
+bench_kangarootwelve_streaming(benchmark::State& state)
+{
+  constexpr size_t mlen = 1ul << 24;
+  const size_t chunk_len = static_cast<size_t>(state.range(0));
+  const size_t threads = static_cast<size_t>(state.range(1));
+  constexpr size_t olen = 64;
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  auto _msg = std::span(msg);
+  kangarootwelve::kangarootwelve_t hasher(threads);
+
+  for (auto _ : state) {
+    for (size_t off = 0; off < mlen; off += chunk_len) {
+      hasher.absorb(_msg.subspan(off, std::min(chunk_len, mlen - off)));
+    }
+    hasher.finalize();
+    hasher.squeeze(out);
+    hasher.reset();
+
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks one-shot SHAKE-{128, 256}, using free function `hash`, with
+// variable length input and squeezed output, which are, mostly, short enough
+// to take the single block fast path.
+template<void (*hash)(std::span<const uint8_t>, std::span<uint8_t>)>
+void
+bench_shake_oneshot(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t olen = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    hash(msg, out);
+
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks one-shot SHAKE-{128, 256}, using free function `hash`,
+// specialized for input and squeezed output of `mlen` and `olen` -bytes, as
+// known at compile-time, compare with `shake*_hash` benchmark, with same input
+// and output length, known only at runtime.
+template<size_t mlen,
+         size_t olen,
+         void (*hash)(std::span<const uint8_t, mlen>, std::span<uint8_t, olen>)>
+void
+bench_shake_fixed(benchmark::State& state)
+{
+  std::array<uint8_t, mlen> msg{};
+  std::array<uint8_t, olen> out{};
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    hash(msg, out);
+
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks 4-way SHAKE-{128, 256} extendable output function, absorbing four
+// equal length inputs and squeezing four equal length outputs, in lock-step,
+// as done when expanding seeds in Kyber, Dilithium and SPHINCS+.
+template<typename xof_x4_t>
+void
+bench_shake_x4(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t olen = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msgs(mlen * 4);
+  std::vector<uint8_t> outs(olen * 4);
+
+  auto _msgs = std::span(msgs);
+  auto _outs = std::span(outs);
+
+  sha3_utils::random_data<uint8_t>(msgs);
+
+  for (auto _ : state) {
+    xof_x4_t hasher;
+    hasher.absorb(_msgs.subspan(0 * mlen, mlen),
+                  _msgs.subspan(1 * mlen, mlen),
+                  _msgs.subspan(2 * mlen, mlen),
+                  _msgs.subspan(3 * mlen, mlen));
+    hasher.finalize();
+    hasher.squeeze(_outs.subspan(0 * olen, olen),
+                   _outs.subspan(1 * olen, olen),
+                   _outs.subspan(2 * olen, olen),
+                   _outs.subspan(3 * olen, olen));
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msgs);
+    benchmark::DoNotOptimize(outs);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed =
+    state.iterations() * (msgs.size() + outs.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Same as above, but stepping four SHAKE-{128, 256} instances, one after
+// another, for comparison.
+template<typename xof_t>
+void
+bench_shake_x4_sequential(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t olen = static_cast<size_t>(state.range(1));
+
+  std::vector<uint8_t> msgs(mlen * 4);
+  std::vector<uint8_t> outs(olen * 4);
+
+  auto _msgs = std::span(msgs);
+  auto _outs = std::span(outs);
+
+  sha3_utils::random_data<uint8_t>(msgs);
+
+  for (auto _ : state) {
+    for (size_t j = 0; j < 4; j++) {
+      xof_t hasher;
+      hasher.absorb(_msgs.subspan(j * mlen, mlen));
+      hasher.finalize();
+      hasher.squeeze(_outs.subspan(j * olen, olen));
+
+      benchmark::DoNotOptimize(hasher);
+    }
+
+    benchmark::DoNotOptimize(msgs);
+    benchmark::DoNotOptimize(outs);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed =
+    state.iterations() * (msgs.size() + outs.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks SHAKE-128 extendable output function, squeezing variable number of
+// whole rate blocks i.e. 168 -bytes each, out of it, after absorbing fixed
+// length input, as done when sampling matrices/ polynomials using SHAKE-128.
+//
+// Note, all output bytes are squeezed in a single call to `squeeze_blocks`
+// function, compare with `shake128` benchmark, squeezing same output length.
+void
+bench_shake128_squeeze_blocks(benchmark::State& state)
+{
+  constexpr size_t rbytes = shake128::RATE / 8;
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t blk_cnt = static_cast<size_t>(state.range(1)) / rbytes;
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(blk_cnt * rbytes);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    shake128::shake128_t hasher;
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.squeeze_blocks(blk_cnt, out);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
+// Benchmarks ParallelHash{128, 256}, splitting variable length input into
+// 8192 -bytes blocks, which are hashed using variable number of worker threads,
+// while squeezing fixed length output.
+//
+// Note, as blocks are hashed by worker threads, throughput is computed using
+// wall clock time.
+template<typename parallelhash_t>
+void
+bench_parallelhash(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t threads = static_cast<size_t>(state.range(1));
+  constexpr size_t blk_len = 8192;
+  constexpr size_t olen = 64;
+
+  std::vector<uint8_t> msg(mlen);
+  std::vector<uint8_t> out(olen);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  for (auto _ : state) {
+    parallelhash_t hasher(blk_len, {}, threads);
+    hasher.absorb(msg);
+    hasher.finalize(olen);
+    hasher.squeeze(out);
+
+    benchmark::DoNotOptimize(hasher);
+    benchmark::DoNotOptimize(msg);
+    benchmark::DoNotOptimize(out);
+    benchmark::ClobberMemory();
+  }
+
+  const size_t bytes_processed = state.iterations() * (msg.size() + out.size());
+  state.SetBytesProcessed(bytes_processed);
+
+#ifdef CYCLES_PER_BYTE
+  state.counters["CYCLES/ BYTE"] = state.counters["CYCLES"] / bytes_processed;
+#endif
+}
+
 BENCHMARK(bench_shake128)
   ->ArgsProduct({ benchmark::CreateRange(64, 16384, 4), { 64 } })
   ->Name("shake128")
@@ -85,3 +473,121 @@ BENCHMARK(bench_shake256)
   ->Name("shake256")
   ->ComputeStatistics("min", compute_min)
   ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake128)
+  ->ArgsProduct({ benchmark::CreateRange(1 << 20, 1 << 30, 32), { 64 } })
+  ->Name("shake128")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake256)
+  ->ArgsProduct({ benchmark::CreateRange(1 << 20, 1 << 30, 32), { 64 } })
+  ->Name("shake256")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake128)
+  ->ArgsProduct({ { 34 }, { 168, 168 * 4, 168 * 16, 168 * 64 } })
+  ->Name("shake128")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake128_squeeze_blocks)
+  ->ArgsProduct({ { 34 }, { 168, 168 * 4, 168 * 16, 168 * 64 } })
+  ->Name("shake128_squeeze_blocks")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake128)
+  ->ArgsProduct({ benchmark::CreateDenseRange(0, 256, 32), { 32 } })
+  ->Name("shake128")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_oneshot<shake128::hash>)
+  ->ArgsProduct({ benchmark::CreateDenseRange(0, 256, 32), { 32 } })
+  ->Name("shake128_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake256)
+  ->ArgsProduct({ benchmark::CreateDenseRange(0, 256, 32), { 32 } })
+  ->Name("shake256")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_oneshot<shake256::hash>)
+  ->ArgsProduct({ benchmark::CreateDenseRange(0, 256, 32), { 32 } })
+  ->Name("shake256_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_oneshot<shake256::hash>)
+  ->Args({ 33, 128 })
+  ->Args({ 1120, 32 })
+  ->Name("shake256_hash")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_fixed<33, 128, shake256::hash<33, 128>>)
+  ->Name("shake256_hash<33, 128>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_fixed<1120, 32, shake256::hash<1120, 32>>)
+  ->Name("shake256_hash<1120, 32>")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_x4<shake128::shake128x4_t>)
+  ->ArgsProduct({ { 34 }, { 168, 504, 840 } })
+  ->Name("shake128x4")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_x4_sequential<shake128::shake128_t>)
+  ->ArgsProduct({ { 34 }, { 168, 504, 840 } })
+  ->Name("shake128x4_sequential")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_x4<shake256::shake256x4_t>)
+  ->ArgsProduct({ { 33, 66 }, { 128, 192 } })
+  ->Name("shake256x4")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_shake_x4_sequential<shake256::shake256_t>)
+  ->ArgsProduct({ { 33, 66 }, { 128, 192 } })
+  ->Name("shake256x4_sequential")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_turboshake128)
+  ->ArgsProduct({ benchmark::CreateRange(64, 16384, 4), { 64 } })
+  ->Name("turboshake128")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_turboshake256)
+  ->ArgsProduct({ benchmark::CreateRange(64, 16384, 4), { 64 } })
+  ->Name("turboshake256")
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_kangarootwelve)
+  ->ArgsProduct({ { 1 << 14, 1 << 24 },
+                  benchmark::CreateRange(
+                    1, std::max(std::thread::hardware_concurrency(), 1u), 2) })
+  ->Name("kangarootwelve")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_kangarootwelve_streaming)
+  ->ArgsProduct({ { 1 << 17, 1 << 20 },
+                  benchmark::CreateRange(
+                    1, std::max(std::thread::hardware_concurrency(), 1u), 2) })
+  ->Name("kangarootwelve_streaming")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_parallelhash<parallelhash::parallelhash128_t>)
+  ->ArgsProduct({ benchmark::CreateRange(1 << 20, 1 << 30, 32),
+                  benchmark::CreateRange(
+                    1, std::max(std::thread::hardware_concurrency(), 1u), 2) })
+  ->Name("parallelhash128")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
+BENCHMARK(bench_parallelhash<parallelhash::parallelhash256_t>)
+  ->ArgsProduct({ benchmark::CreateRange(1 << 20, 1 << 30, 32),
+                  benchmark::CreateRange(
+                    1, std::max(std::thread::hardware_concurrency(), 1u), 2) })
+  ->Name("parallelhash256")
+  ->UseRealTime()
+  ->ComputeStatistics("min", compute_min)
+  ->ComputeStatistics("max", compute_max);
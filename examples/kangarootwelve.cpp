@@ -0,0 +1,41 @@
+#include "kangarootwelve.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Compile it using
+//
+// g++ -std=c++20 -Wall -O3 -march=native -I include examples/kangarootwelve.cpp
+// -pthread
+int
+main()
+{
+  constexpr size_t ilen = 1ul << 20;
+  constexpr size_t olen = 40;
+
+  std::vector<uint8_t> msg(ilen, 0);
+  std::vector<uint8_t> cust{ 'e', 'x', 'a', 'm', 'p', 'l', 'e' };
+  std::vector<uint8_t> dig(olen, 0);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  // Create KangarooTwelve hasher, which hashes leaves using as many worker
+  // threads, as available cores. Output doesn't depend on number of threads.
+  kangarootwelve::kangarootwelve_t hasher(std::thread::hardware_concurrency());
+
+  // Absorb message bytes into KangarooTwelve tree
+  hasher.absorb(msg);
+  // Finalize, using an optional customization string
+  hasher.finalize(cust);
+
+  // Squeeze `olen` -bytes out of sponge, one can squeeze arbitrary many bytes,
+  // by calling `squeeze` arbitrary many times.
+  hasher.squeeze(dig);
+
+  std::cout << "KangarooTwelve" << std::endl << std::endl;
+  std::cout << "Input  : " << ilen << " random bytes\n";
+  std::cout << "Output : " << sha3_utils::to_hex(dig) << "\n";
+
+  return EXIT_SUCCESS;
+}
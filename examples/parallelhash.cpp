@@ -0,0 +1,44 @@
+#include "parallelhash.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Compile it using
+//
+// g++ -std=c++20 -Wall -O3 -march=native -I include examples/parallelhash.cpp
+// -pthread
+int
+main()
+{
+  constexpr size_t ilen = 1ul << 20;
+  constexpr size_t blen = 8192;
+  constexpr size_t olen = 32;
+
+  std::vector<uint8_t> msg(ilen, 0);
+  std::vector<uint8_t> cust{ 'e', 'x', 'a', 'm', 'p', 'l', 'e' };
+  std::vector<uint8_t> dig(olen, 0);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  // Create ParallelHash128 hasher, which splits message into `blen` -bytes
+  // blocks, hashed using as many worker threads, as available cores. Output
+  // doesn't depend on number of threads.
+  parallelhash::parallelhash128_t hasher(
+    blen, cust, std::thread::hardware_concurrency());
+
+  // Absorb message bytes, can be called arbitrary many times
+  hasher.absorb(msg);
+  // Finalize, requesting `olen` -bytes output. Calling finalize() without
+  // any argument computes ParallelHashXOF128 instead.
+  hasher.finalize(olen);
+
+  // Squeeze `olen` -bytes out of sponge
+  hasher.squeeze(dig);
+
+  std::cout << "ParallelHash128" << std::endl << std::endl;
+  std::cout << "Input  : " << ilen << " random bytes\n";
+  std::cout << "Output : " << sha3_utils::to_hex(dig) << "\n";
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+#include "turboshake128.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <vector>
+
+// Compile it using
+//
+// g++ -std=c++20 -Wall -O3 -march=native -I include examples/turboshake128.cpp
+int
+main()
+{
+  constexpr size_t ilen = 32;
+  constexpr size_t olen = 40;
+
+  std::vector<uint8_t> msg(ilen, 0);
+  std::vector<uint8_t> dig(olen, 0);
+  auto _dig = std::span(dig);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  // Create turboshake128 hasher
+  turboshake128::turboshake128_t hasher;
+
+  // Absorb message bytes into sponge state
+  hasher.absorb(msg);
+  // Finalize sponge state, using domain separation byte ∈ [0x01, 0x7f]
+  hasher.finalize(0x1f);
+
+  // Squeeze total `olen` -bytes out of sponge, a single byte at a time.
+  // One can request arbitrary many bytes of output, by calling `squeeze`
+  // arbitrary many times.
+  for (size_t i = 0; i < olen; i++) {
+    hasher.squeeze(_dig.subspan(i, 1));
+  }
+
+  std::cout << "TurboSHAKE-128" << std::endl << std::endl;
+  std::cout << "Input  : " << sha3_utils::to_hex(msg) << "\n";
+  std::cout << "Output : " << sha3_utils::to_hex(dig) << "\n";
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+#pragma once
+#include "sponge_batched.hpp"
+#include "turboshake128.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// KangarooTwelve Extendable Output Function : tree hash mode on top of
+// TurboSHAKE128, which uses Keccak-p[1600, 12] permutation
+namespace kangarootwelve {
+
+// Byte length of each chunk of S = M || C || length_encode(|C|).
+constexpr size_t CHUNK_LEN = 8192;
+
+// Byte length of chaining value, computed for each leaf node.
+constexpr size_t CV_LEN = 32;
+
+// Domain separation bytes, used for finalizing TurboSHAKE128 sponge of the
+// single node ( when |S| <= 8192 ), of a leaf node and of the final node.
+constexpr uint8_t SINGLE_NODE_DOM_SEP = 0x07;
+constexpr uint8_t LEAF_DOM_SEP = 0x0b;
+constexpr uint8_t FINAL_NODE_DOM_SEP = 0x06;
+
+// Encodes `x` as big-endian byte string with no leading zero bytes, followed
+// by a single byte holding its length, writing result into `enc` and returning
+// number of bytes written.
+//
+// See section 3.3 of KangarooTwelve specification https://ia.cr/2016/770
+static inline constexpr size_t
+length_encode(size_t x, std::span<uint8_t, sizeof(size_t) + 1> enc)
+{
+  constexpr size_t max_len = sizeof(size_t);
+
+  size_t len = 0;
+  while ((len < max_len) && ((x >> (len * 8)) != 0)) {
+    len++;
+  }
+
+  for (size_t i = 0; i < max_len; i++) {
+    if (i < len) {
+      enc[i] = static_cast<uint8_t>(x >> ((len - 1 - i) * 8));
+    }
+  }
+  enc[len] = static_cast<uint8_t>(len);
+
+  return len + 1;
+}
+
+// Computes chaining value of a single leaf node i.e. TurboSHAKE128(chunk,
+// 0x0b, 32), using sponge routines.
+static inline void
+leaf(std::span<const uint8_t> chunk, std::span<uint8_t, CV_LEN> cv)
+{
+  sponge::oneshot<turboshake128::RATE, turboshake128::ROUNDS>(
+    chunk, LEAF_DOM_SEP, cv);
+}
+
+// Computes chaining values of all leaf nodes, each of 8192 -bytes, held in
+// `chunks`, writing them in order, into `cvs`. Leaves are hashed using batched
+// permutations, spread across threads of `pool`. Result doesn't depend on
+// number of threads.
+static inline void
+leaves(std::span<const uint8_t> chunks,
+       std::span<uint8_t> cvs,
+       sha3_utils::worker_pool_t& pool)
+{
+  sponge::oneshot_many<turboshake128::RATE, turboshake128::ROUNDS>(
+    chunks, CHUNK_LEN, LEAF_DOM_SEP, cvs, CV_LEN, pool);
+}
+
+// KangarooTwelve Extendable Output Function (Xof), which splits S = M || C ||
+// length_encode(|C|) into 8192 -bytes chunks, s.t. all but the first chunk are
+// leaf nodes, which are hashed independently, using batched permutations and
+// worker threads, while first chunk and chaining values of leaves are
+// absorbed into the final node. Output doesn't depend on number of threads.
+//
+// See KangarooTwelve specification https://ia.cr/2016/770
+struct kangarootwelve_t
+{
+private:
+  // TurboSHAKE128 sponge of the single/ final node
+  uint64_t state[keccak::LANE_CNT]{};
+  size_t offset = 0;
+  size_t squeezable = 0;
+
+  // Partially filled leaf node
+  std::array<uint8_t, CHUNK_LEN> leaf_buf{};
+  size_t leaf_len = 0;
+
+  size_t absorbed = 0; // # -of bytes of S absorbed so far
+  size_t leaf_cnt = 0; // # -of leaves absorbed into final node
+  alignas(4) bool finalized = false; // all message bytes absorbed ?
+
+  // Worker threads used for hashing leaves, kept alive across absorb calls
+  std::unique_ptr<sha3_utils::worker_pool_t> pool;
+
+  // Absorbs bytes into the single/ final node sponge.
+  inline void absorb_node(std::span<const uint8_t> bytes)
+  {
+    sponge::absorb<turboshake128::RATE, turboshake128::ROUNDS>(
+      state, offset, bytes);
+  }
+
+  // Absorbs bytes of S, routing them either into the first chunk, which lives
+  // in final node, or into leaf nodes.
+  inline void absorb_s(std::span<const uint8_t> msg)
+  {
+    // First chunk goes into final node, as it's unknown yet whether |S| >
+    // 8192, both single node and final node start absorbing S alike.
+    if (absorbed < CHUNK_LEN) {
+      const size_t len = std::min(CHUNK_LEN - absorbed, msg.size());
+
+      absorb_node(msg.first(len));
+      absorbed += len;
+      msg = msg.subspan(len);
+    }
+
+    if (msg.empty()) {
+      return;
+    }
+
+    if (absorbed == CHUNK_LEN) {
+      constexpr std::array<uint8_t, 8> marker{ 0x03 };
+      absorb_node(marker);
+    }
+
+    absorbed += msg.size();
+
+    // Complete partially filled leaf
+    if (leaf_len > 0) {
+      const size_t len = std::min(CHUNK_LEN - leaf_len, msg.size());
+
+      std::copy_n(msg.begin(), len, leaf_buf.begin() + leaf_len);
+      leaf_len += len;
+      msg = msg.subspan(len);
+
+      if (leaf_len < CHUNK_LEN || msg.empty()) {
+        // Last leaf can't be hashed, before more bytes arrive, as it's
+        // otherwise the final, possibly partial, leaf.
+        return;
+      }
+
+      std::array<uint8_t, CV_LEN> cv{};
+      leaf(leaf_buf, cv);
+      absorb_node(cv);
+
+      leaf_len = 0;
+      leaf_cnt++;
+    }
+
+    // Hash all full leaves, leaving at least one byte behind, for last leaf
+    const size_t cnt = (msg.size() - 1) / CHUNK_LEN;
+    if (cnt > 0) {
+      std::vector<uint8_t> cvs(cnt * CV_LEN);
+
+      leaves(msg.first(cnt * CHUNK_LEN), cvs, *pool);
+      absorb_node(cvs);
+
+      leaf_cnt += cnt;
+      msg = msg.subspan(cnt * CHUNK_LEN);
+    }
+
+    std::copy(msg.begin(), msg.end(), leaf_buf.begin());
+    leaf_len = msg.size();
+  }
+
+public:
+  // Creates a KangarooTwelve hasher, which hashes leaves using at most
+  // `threads` -many threads, including the calling one. Worker threads are
+  // spawned on first use and live as long as the hasher.
+  inline explicit kangarootwelve_t(const size_t threads = 1)
+    : pool(std::make_unique<sha3_utils::worker_pool_t>(threads))
+  {
+  }
+
+  // Given N -many bytes input message, this routine consumes those into
+  // KangarooTwelve tree. Message bytes, which are not yet hashed, are buffered
+  // internally, at most a single leaf.
+  //
+  // Note, this routine can be called arbitrary number of times, each time with
+  // arbitrary bytes of input message, until the state is finalized ( by calling
+  // routine with similar name ). Once finalized, it can't absorb any more
+  // message bytes.
+  inline void absorb(std::span<const uint8_t> msg)
+  {
+    if (!finalized) {
+      absorb_s(msg);
+    }
+  }
+
+  // Same as above, but message is given as a sequence of ( possibly empty )
+  // fragments, which are absorbed as if they were concatenated. As leaves are
+  // already staged in an internal buffer, fragments are absorbed one after
+  // another.
+  inline void absorb(std::span<const std::span<const uint8_t>> frags)
+  {
+    if (!finalized) {
+      for (const auto frag : frags) {
+        absorb_s(frag);
+      }
+    }
+  }
+
+  // After consuming arbitrary many input bytes, this routine is invoked with
+  // customization string C ( can be empty ), when no more input bytes
+  // remaining to be consumed. It absorbs C || length_encode(|C|), hashes last
+  // leaf and finalizes single/ final node.
+  //
+  // Note, once this routine is called, calling absorb() or finalize() again, on
+  // same KangarooTwelve object, doesn't do anything. After finalization, one
+  // might intend to read arbitrary many bytes by squeezing sponge, which is
+  // done by calling squeeze() function, as many times required.
+  inline void finalize(std::span<const uint8_t> cust = {})
+  {
+    if (finalized) {
+      return;
+    }
+
+    std::array<uint8_t, sizeof(size_t) + 1> enc{};
+    const size_t enc_len = length_encode(cust.size(), enc);
+
+    absorb_s(cust);
+    absorb_s(std::span(enc).first(enc_len));
+
+    constexpr size_t rate = turboshake128::RATE;
+    constexpr size_t rounds = turboshake128::ROUNDS;
+
+    if (absorbed <= CHUNK_LEN) {
+      sponge::finalize<rate, rounds>(state, offset, SINGLE_NODE_DOM_SEP);
+    } else {
+      std::array<uint8_t, CV_LEN> cv{};
+      leaf(std::span(leaf_buf).first(leaf_len), cv);
+      absorb_node(cv);
+      leaf_cnt++;
+
+      // length_encode(n - 1) || 0xFF || 0xFF, absorbed at once
+      std::array<uint8_t, sizeof(size_t) + 3> tail{};
+      auto _tail = std::span(tail);
+
+      const size_t cnt_len =
+        length_encode(leaf_cnt, _tail.first<sizeof(size_t) + 1>());
+      tail[cnt_len + 0] = 0xff;
+      tail[cnt_len + 1] = 0xff;
+
+      absorb_node(_tail.first(cnt_len + 2));
+
+      sponge::finalize<rate, rounds>(state, offset, FINAL_NODE_DOM_SEP);
+    }
+
+    finalized = true;
+    squeezable = rate / 8;
+  }
+
+  // After sponge state is finalized, arbitrary many output bytes can be
+  // squeezed by calling this function any number of times required.
+  inline void squeeze(std::span<uint8_t> dig)
+  {
+    if (finalized) {
+      sponge::squeeze<turboshake128::RATE, turboshake128::ROUNDS>(
+        state, squeezable, dig);
+    }
+  }
+
+  // Reset the internal state of the KangarooTwelve hasher, now it can again be
+  // used for another absorb->finalize->squeeze cycle, using same number of
+  // worker threads.
+  inline void reset()
+  {
+    std::fill(std::begin(state), std::end(state), 0);
+    offset = 0;
+    squeezable = 0;
+    leaf_buf.fill(0);
+    leaf_len = 0;
+    absorbed = 0;
+    leaf_cnt = 0;
+    finalized = false;
+  }
+};
+
+}
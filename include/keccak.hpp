@@ -4,7 +4,16 @@
 #include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include "keccak_dispatch.hpp"
+#include "utils.hpp"
+
+#if defined KECCAK_X86_64
+#include <immintrin.h>
+#endif
 
 // Keccak-p[1600, 24] permutation
 namespace keccak {
@@ -125,7 +134,17 @@ compute_rcs()
 // https://dx.doi.org/10.s6028/NIST.FIPS.202
 static constexpr auto RC = compute_rcs();
 
-#if defined __APPLE__ && defined __aarch64__ // On Apple Silicon
+// Compile-time check to ensure that number of rounds of Keccak-p[1600, nr]
+// permutation ∈ [1, 24]. When nr < 24, last `nr` rounds of Keccak-p[1600, 24]
+// are applied, i.e. round indices ∈ [24 - nr, 24), so that round constants
+// are picked from offset 24 - nr of `RC`.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+constexpr bool
+check_rounds(const size_t rounds)
+{
+  return (rounds > 0) & (rounds <= ROUNDS);
+}
 
 // Keccak-p[1600, 24] round function, applying all five step mapping functions,
 // updating state array. Note this implementation of round function applies four
@@ -140,7 +159,10 @@ static constexpr auto RC = compute_rcs();
 //
 // This Keccak round function implementation is specifically targeting Apple
 // Silicon CPUs. And this implementation collects a lot of inspiration from
-// https://github.com/bwesterb/armed-keccak.git.
+// https://github.com/bwesterb/armed-keccak.git. θ, ρ and π are fused through
+// `bc`/ `d` temporaries and lanes are permuted in-place, so no intermediate
+// state array is needed. It's also available on other targets, where it can be
+// selected by defining `KECCAK_USE_ROUNDX4`.
 static inline constexpr void
 roundx4(uint64_t* const state, const size_t ridx)
 {
@@ -588,8 +610,6 @@ roundx4(uint64_t* const state, const size_t ridx)
   state[24] = bc[4] ^ (bc[1] & ~bc[0]);
 }
 
-#else // On everywhere else
-
 // Keccak-p[1600, 24] step mapping function θ, see section 3.2.1 of SHA3
 // specification https://dx.doi.org/10.6028/NIST.FIPS.202
 static inline constexpr void
@@ -736,24 +756,688 @@ roundx2(uint64_t* const state, const size_t ridx)
   iota(state, ridx + 1);
 }
 
-#endif
+// Keccak-p[1600, 24] round function, which applies all five step mapping
+// functions, for a single round `ridx`, updating state array in-place. It's
+// used for applying the leading round(s), when number of rounds is not a
+// multiple of what other round functions apply in a single call.
+static inline constexpr void
+roundx1(uint64_t* const state, const size_t ridx)
+{
+  uint64_t tmp[LANE_CNT]{};
 
-// Keccak-p[1600, 24] permutation, applying 24 rounds of permutation
-// on state of dimension 5 x 5 x 64 ( = 1600 ) -bits, using algorithm 7
-// defined in section 3.3 of SHA3 specification
-// https://dx.doi.org/10.6028/NIST.FIPS.202
+  theta(state);
+  rho(state);
+  pi(state, tmp);
+  chi(tmp);
+  iota(tmp, ridx);
+
+  std::copy_n(tmp, LANE_CNT, state);
+}
+
+// Keccak-p[1600, nr] permutation, built on top of `roundx2`, applying last
+// `rounds` rounds of permutation on state, in-place. This is the default
+// permutation, on all targets, other than Apple Silicon.
+template<size_t rounds = ROUNDS>
 inline constexpr void
-permute(uint64_t state[LANE_CNT])
+permute_roundx2(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
 {
-#if defined __APPLE__ && defined __aarch64__ // On Apple Silicon
-  for (size_t i = 0; i < ROUNDS; i += 4) {
-    roundx4(state, i);
+  constexpr size_t start = ROUNDS - rounds;
+
+  if constexpr (rounds % 2 == 1) {
+    roundx1(state, start);
   }
-#else // On everywhere else
-  for (size_t i = 0; i < ROUNDS; i += 2) {
+
+  for (size_t i = start + rounds % 2; i < ROUNDS; i += 2) {
     roundx2(state, i);
   }
+}
+
+// Keccak-p[1600, nr] permutation, built on top of `roundx4`, applying last
+// `rounds` rounds of permutation on a local copy of the state. As `roundx4` is
+// fully unrolled and only ever indexes the state with constants, compiler can
+// keep all 25 lanes in registers ( or, spill them to stack, as register
+// pressure demands ), across all rounds, without going through caller's
+// memory.
+//
+// This is the default permutation on Apple Silicon, while on other targets, it
+// is used when this library is compiled with `KECCAK_USE_ROUNDX4` defined.
+template<size_t rounds = ROUNDS>
+inline constexpr void
+permute_roundx4(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+  constexpr size_t start = ROUNDS - rounds;
+
+  uint64_t s[LANE_CNT]{};
+  std::copy_n(state, LANE_CNT, s);
+
+  for (size_t i = start; i < start + rounds % 4; i++) {
+    roundx1(s, i);
+  }
+
+  for (size_t i = start + rounds % 4; i < ROUNDS; i += 4) {
+    roundx4(s, i);
+  }
+
+  std::copy_n(s, LANE_CNT, state);
+}
+
+// Lanes of Keccak-p[1600, 24] permutation state, which are kept complemented
+// by `permute_lc`, between rounds. This set of lanes is invariant under the
+// lane complementing transform of χ, as implemented in `round_lc`.
+//
+// See section 2.2 of Keccak implementation overview document
+// https://keccak.team/files/Keccak-implementation-3.2.pdf
+static constexpr size_t LC_LANES[]{ 1, 2, 8, 12, 17, 20 };
+
+// Keccak-p[1600, 24] round function, applying all five step mapping functions
+// on state `a`, writing resulting state to `e`, s.t. both states have lanes
+// listed in `LC_LANES` complemented. Computing χ on such a state requires only
+// one NOT per row ( instead of five ), as most of `~a & b` terms turn into
+// either `a | b` or `a & b`.
+//
+// When `mwords` > 0, first `mwords` lanes of message block `m` are XOR-ed into
+// lanes of `a` as they are read by θ, s.t. absorbing a block costs no extra
+// pass over the state. As complementing commutes with XOR, `m` is not
+// complemented.
+//
+// See section 2.2 of https://keccak.team/files/Keccak-implementation-3.2.pdf
+template<size_t mwords = 0>
+static inline constexpr void
+round_lc(const uint64_t* const __restrict a,
+         uint64_t* const __restrict e,
+         const size_t ridx,
+         const uint64_t* const __restrict m = nullptr)
+{
+  uint64_t c[5]{}, d[5]{}, b[5]{};
+
+  const auto lane = [&](const size_t i) {
+    if constexpr (mwords > 0) {
+      if (i < mwords) {
+        return a[i] ^ m[i];
+      }
+    }
+    return a[i];
+  };
+
+  c[0] = lane(0) ^ lane(5) ^ lane(10) ^ lane(15) ^ lane(20);
+  c[1] = lane(1) ^ lane(6) ^ lane(11) ^ lane(16) ^ lane(21);
+  c[2] = lane(2) ^ lane(7) ^ lane(12) ^ lane(17) ^ lane(22);
+  c[3] = lane(3) ^ lane(8) ^ lane(13) ^ lane(18) ^ lane(23);
+  c[4] = lane(4) ^ lane(9) ^ lane(14) ^ lane(19) ^ lane(24);
+
+  d[0] = c[4] ^ std::rotl(c[1], 1);
+  d[1] = c[0] ^ std::rotl(c[2], 1);
+  d[2] = c[1] ^ std::rotl(c[3], 1);
+  d[3] = c[2] ^ std::rotl(c[4], 1);
+  d[4] = c[3] ^ std::rotl(c[0], 1);
+
+  // Row 0
+  b[0] = lane(0) ^ d[0];
+  b[1] = std::rotl(lane(6) ^ d[1], ROT[6]);
+  b[2] = std::rotl(lane(12) ^ d[2], ROT[12]);
+  b[3] = std::rotl(lane(18) ^ d[3], ROT[18]);
+  b[4] = std::rotl(lane(24) ^ d[4], ROT[24]);
+
+  e[0] = b[0] ^ (b[1] | b[2]) ^ RC[ridx];
+  e[1] = b[1] ^ (~b[2] | b[3]);
+  e[2] = b[2] ^ (b[3] & b[4]);
+  e[3] = b[3] ^ (b[4] | b[0]);
+  e[4] = b[4] ^ (b[0] & b[1]);
+
+  // Row 1
+  b[0] = std::rotl(lane(3) ^ d[3], ROT[3]);
+  b[1] = std::rotl(lane(9) ^ d[4], ROT[9]);
+  b[2] = std::rotl(lane(10) ^ d[0], ROT[10]);
+  b[3] = std::rotl(lane(16) ^ d[1], ROT[16]);
+  b[4] = std::rotl(lane(22) ^ d[2], ROT[22]);
+
+  e[5] = b[0] ^ (b[1] | b[2]);
+  e[6] = b[1] ^ (b[2] & b[3]);
+  e[7] = b[2] ^ (b[3] | ~b[4]);
+  e[8] = b[3] ^ (b[4] | b[0]);
+  e[9] = b[4] ^ (b[0] & b[1]);
+
+  // Row 2
+  b[0] = std::rotl(lane(1) ^ d[1], ROT[1]);
+  b[1] = std::rotl(lane(7) ^ d[2], ROT[7]);
+  b[2] = std::rotl(lane(13) ^ d[3], ROT[13]);
+  b[3] = std::rotl(lane(19) ^ d[4], ROT[19]);
+  b[4] = std::rotl(lane(20) ^ d[0], ROT[20]);
+
+  e[10] = b[0] ^ (b[1] | b[2]);
+  e[11] = b[1] ^ (b[2] & b[3]);
+  e[12] = b[2] ^ (~b[3] & b[4]);
+  e[13] = ~b[3] ^ (b[4] | b[0]);
+  e[14] = b[4] ^ (b[0] & b[1]);
+
+  // Row 3
+  b[0] = std::rotl(lane(4) ^ d[4], ROT[4]);
+  b[1] = std::rotl(lane(5) ^ d[0], ROT[5]);
+  b[2] = std::rotl(lane(11) ^ d[1], ROT[11]);
+  b[3] = std::rotl(lane(17) ^ d[2], ROT[17]);
+  b[4] = std::rotl(lane(23) ^ d[3], ROT[23]);
+
+  e[15] = b[0] ^ (b[1] & b[2]);
+  e[16] = b[1] ^ (b[2] | b[3]);
+  e[17] = b[2] ^ (~b[3] | b[4]);
+  e[18] = ~b[3] ^ (b[4] & b[0]);
+  e[19] = b[4] ^ (b[0] | b[1]);
+
+  // Row 4
+  b[0] = std::rotl(lane(2) ^ d[2], ROT[2]);
+  b[1] = std::rotl(lane(8) ^ d[3], ROT[8]);
+  b[2] = std::rotl(lane(14) ^ d[4], ROT[14]);
+  b[3] = std::rotl(lane(15) ^ d[0], ROT[15]);
+  b[4] = std::rotl(lane(21) ^ d[1], ROT[21]);
+
+  e[20] = b[0] ^ (~b[1] & b[2]);
+  e[21] = ~b[1] ^ (b[2] | b[3]);
+  e[22] = b[2] ^ (b[3] & b[4]);
+  e[23] = b[3] ^ (b[4] | b[0]);
+  e[24] = b[4] ^ (b[0] & b[1]);
+}
+
+// Keccak-p[1600, 24] permutation, using lane complementing transform, applying
+// 24 rounds of permutation on state, which is kept in local variables across
+// all rounds, alternating between two sets of 25 lanes. Lanes listed in
+// `LC_LANES` are complemented once when entering and once when leaving this
+// function, so result is same as `permute`.
+//
+// This function is used in place of the default permutation, by all hashers
+// and xofs, when this library is compiled with `KECCAK_USE_LANE_COMPLEMENTING`
+// defined, or when it's picked by runtime dispatch. Only then sponges absorb
+// full message blocks using `absorb_blocks_lc`, see `permute_is_lc`.
+template<size_t rounds = ROUNDS>
+inline constexpr void
+permute_lc(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+  constexpr size_t start = ROUNDS - rounds;
+
+  uint64_t a[LANE_CNT]{}, e[LANE_CNT]{};
+
+  std::copy_n(state, LANE_CNT, a);
+  for (const size_t i : LC_LANES) {
+    a[i] = ~a[i];
+  }
+
+  if constexpr (rounds % 2 == 1) {
+    round_lc(a, e, start);
+    std::copy_n(e, LANE_CNT, a);
+  }
+
+  for (size_t i = start + rounds % 2; i < ROUNDS; i += 2) {
+    round_lc(a, e, i);
+    round_lc(e, a, i + 1);
+  }
+
+  for (const size_t i : LC_LANES) {
+    a[i] = ~a[i];
+  }
+  std::copy_n(a, LANE_CNT, state);
+}
+
+// Compile-time check to ensure that rate portion of Keccak[c] sponge is a
+// non-zero multiple of lane bitwidth, which is less than 1600.
+constexpr bool
+check_rate(const size_t rate)
+{
+  return (rate > 0) & (rate < 1600) & (rate % LANE_BW == 0);
+}
+
+// Absorbs all message blocks, each of `rate/ 8` -bytes, held one after
+// another in `blks`, into Keccak[c] sponge state, applying last `rounds`
+// rounds of Keccak-p[1600, nr] permutation after each of them. Result is same
+// as XOR-ing each block into state and calling `permute_lc`, but the state is
+// kept in local lanes across all blocks ( so that it never goes back to
+// caller's memory, in between ), lanes listed in `LC_LANES` are complemented
+// only once, and each block is XOR-ed into the state by θ of the first round,
+// see `round_lc`.
+template<size_t rate, size_t rounds = ROUNDS>
+inline constexpr void
+absorb_blocks_lc(uint64_t state[LANE_CNT], std::span<const uint8_t> blks)
+  requires(check_rate(rate) && check_rounds(rounds))
+{
+  constexpr size_t rbytes = rate / 8;
+  constexpr size_t rwords = rbytes / 8;
+  constexpr size_t start = ROUNDS - rounds;
+
+  const size_t blk_cnt = blks.size() / rbytes;
+
+  uint64_t a[LANE_CNT]{}, e[LANE_CNT]{};
+
+  std::copy_n(state, LANE_CNT, a);
+  for (const size_t i : LC_LANES) {
+    a[i] = ~a[i];
+  }
+
+  for (size_t b = 0; b < blk_cnt; b++) {
+    const auto blk = blks.subspan(b * rbytes).template first<rbytes>();
+
+    uint64_t m[rwords]{};
+    if ((std::endian::native == std::endian::little) &&
+        !std::is_constant_evaluated()) {
+      std::memcpy(m, blk.data(), rbytes);
+    } else {
+      sha3_utils::le_bytes_to_u64_words<rate>(blk, m);
+    }
+
+    if constexpr (rounds % 2 == 1) {
+      round_lc<rwords>(a, e, start, m);
+      std::copy_n(e, LANE_CNT, a);
+    } else {
+      round_lc<rwords>(a, e, start, m);
+      round_lc(e, a, start + 1);
+    }
+
+    for (size_t i = start + 2 - rounds % 2; i < ROUNDS; i += 2) {
+      round_lc(a, e, i);
+      round_lc(e, a, i + 1);
+    }
+  }
+
+  for (const size_t i : LC_LANES) {
+    a[i] = ~a[i];
+  }
+  std::copy_n(a, LANE_CNT, state);
+}
+
+// Keccak-p[1600, nr] permutation, looping over rounds, s.t. loop body applies
+// a single round, on a local copy of the state. Unlike other kernels, which
+// unroll two or four rounds, only lanes of one round are unrolled, so it takes
+// less instruction cache than any of them, while being about as fast as
+// `permute_roundx2`, when measured in isolation. When hashing is interleaved
+// with other work, it evicts less of caller's hot code.
+//
+// This function is used in place of the default permutation, by all hashers
+// and xofs, when this library is compiled with `KECCAK_USE_COMPACT` defined.
+template<size_t rounds = ROUNDS>
+inline constexpr void
+permute_compact(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+  uint64_t s[LANE_CNT]{};
+  std::copy_n(state, LANE_CNT, s);
+
+#if defined __clang__
+#pragma clang loop unroll(disable)
+#elif defined __GNUG__
+#pragma GCC unroll 1
+#endif
+  for (size_t r = ROUNDS - rounds; r < ROUNDS; r++) {
+    uint64_t c[5]{}, d[5]{}, b[LANE_CNT]{};
+
+    // θ step mapping function
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+    for (size_t i = 0; i < 5; i++) {
+      c[i] = s[i] ^ s[i + 5] ^ s[i + 10] ^ s[i + 15] ^ s[i + 20];
+    }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+    for (size_t i = 0; i < 5; i++) {
+      d[i] = c[(i + 4) % 5] ^ std::rotl(c[(i + 1) % 5], 1);
+    }
+
+    // θ, ρ and π step mapping functions, fused together
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 25
+#endif
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      const size_t j = PERM[i];
+      b[i] = std::rotl(s[j] ^ d[j % 5], ROT[j]);
+    }
+
+    // χ step mapping function
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+    for (size_t i = 0; i < LANE_CNT; i += 5) {
+      s[i + 0] = b[i + 0] ^ (~b[i + 1] & b[i + 2]);
+      s[i + 1] = b[i + 1] ^ (~b[i + 2] & b[i + 3]);
+      s[i + 2] = b[i + 2] ^ (~b[i + 3] & b[i + 4]);
+      s[i + 3] = b[i + 3] ^ (~b[i + 4] & b[i + 0]);
+      s[i + 4] = b[i + 4] ^ (~b[i + 0] & b[i + 1]);
+    }
+
+    // ι step mapping function
+    s[0] ^= RC[r];
+  }
+
+  std::copy_n(s, LANE_CNT, state);
+}
+
+#if defined KECCAK_X86_64
+
+// Leftwards circular rotation of each 64 -bit lane of a 256 -bit vector, s.t.
+// rotation offset of each lane is provided in corresponding lane of `n`. Note,
+// when offset is 0, variable right shift by 64 bit places produces 0, so
+// result is the input lane itself.
+KECCAK_TARGET("avx2") static inline __m256i
+rotlv_avx2(const __m256i a, const __m256i n)
+{
+  const auto lane_bw = _mm256_set1_epi64x(LANE_BW);
+  const auto t0 = _mm256_sllv_epi64(a, n);
+  const auto t1 = _mm256_srlv_epi64(a, _mm256_sub_epi64(lane_bw, n));
+  return _mm256_or_si256(t0, t1);
+}
+
+// Keccak-p[1600, 24] round function, for a single permutation state, held in
+// seven 256 -bit registers, s.t. `a00` holds lane (0, 0) in all four 64 -bit
+// words, `r0` holds lanes (1..4, 0) of row 0, `c0` holds lanes (0, 1..4) of
+// column 0 and the remaining 4 x 4 lanes are held in `p`, which are rows i.e.
+// p[y-1] holds lanes (1..4, y), when this function is entered.
+//
+// Note, π maps row y of the state onto column y, so after θ and ρ are applied
+// row-wise, π only needs a single `vpermq` for each of p[y-1], and then χ is
+// computed column-wise, without any horizontal operation. Finally a 4 x 4
+// transpose brings p back into row-major form, for next round.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+KECCAK_TARGET("avx2") static inline void
+round_avx2(__m256i& a00,
+           __m256i& r0,
+           __m256i& c0,
+           __m256i p[4],
+           const __m256i rot[6],
+           const size_t ridx)
+{
+  // θ step mapping function, lanes of column parity `c` are (1..4)
+  auto c = _mm256_xor_si256(r0, p[0]);
+  c = _mm256_xor_si256(c, p[1]);
+  c = _mm256_xor_si256(c, p[2]);
+  c = _mm256_xor_si256(c, p[3]);
+
+  // parity of column 0, broadcasted to all four lanes
+  auto t = _mm256_xor_si256(c0, _mm256_shuffle_epi32(c0, 0b01001110));
+  t = _mm256_xor_si256(t, _mm256_permute4x64_epi64(t, 0b01001110));
+  const auto c_0 = _mm256_xor_si256(a00, t);
+
+  const auto rc = rotlv_avx2(c, _mm256_set1_epi64x(1));
+  const auto rc_0 = rotlv_avx2(c_0, _mm256_set1_epi64x(1));
+
+  // d[1..4] = c[0..3] ^ rotl(c[2..4, 0], 1)
+  const auto cm1 = _mm256_blend_epi32(
+    _mm256_permute4x64_epi64(c, 0b10010011), c_0, 0b00000011);
+  const auto cp1 = _mm256_blend_epi32(
+    _mm256_permute4x64_epi64(rc, 0b00111001), rc_0, 0b11000000);
+  const auto d = _mm256_xor_si256(cm1, cp1);
+
+  // d[0] = c[4] ^ rotl(c[1], 1), broadcasted to all four lanes
+  const auto d_0 = _mm256_xor_si256(_mm256_permute4x64_epi64(c, 0b11111111),
+                                    _mm256_permute4x64_epi64(rc, 0b00000000));
+
+  a00 = _mm256_xor_si256(a00, d_0);
+  r0 = _mm256_xor_si256(r0, d);
+  c0 = _mm256_xor_si256(c0, d_0);
+  p[0] = _mm256_xor_si256(p[0], d);
+  p[1] = _mm256_xor_si256(p[1], d);
+  p[2] = _mm256_xor_si256(p[2], d);
+  p[3] = _mm256_xor_si256(p[3], d);
+
+  // ρ step mapping function, lane (0, 0) is never rotated
+  r0 = rotlv_avx2(r0, rot[0]);
+  c0 = rotlv_avx2(c0, rot[1]);
+  p[0] = rotlv_avx2(p[0], rot[2]);
+  p[1] = rotlv_avx2(p[1], rot[3]);
+  p[2] = rotlv_avx2(p[2], rot[4]);
+  p[3] = rotlv_avx2(p[3], rot[5]);
+
+  // π step mapping function, lane (x, y) moves to (y, 2x + 3y). Row 0 becomes
+  // column 0, diagonal lanes (y, y) become row 0 and remaining lanes of row y,
+  // along with lane (0, y), become column y.
+  const auto b_r01 = _mm256_blend_epi32(p[0], p[1], 0b00001100);
+  const auto b_r23 = _mm256_blend_epi32(p[2], p[3], 0b11000000);
+  const auto b_r0 = _mm256_blend_epi32(b_r01, b_r23, 0b11110000);
+  const auto b_c0 = _mm256_permute4x64_epi64(r0, 0b01110010);
+
+  __m256i b[4];
+  b[0] = _mm256_blend_epi32(_mm256_permute4x64_epi64(p[0], 0b10000111),
+                            _mm256_permute4x64_epi64(c0, 0b00000000),
+                            0b00110000);
+  b[1] = _mm256_blend_epi32(_mm256_permute4x64_epi64(p[1], 0b11001000),
+                            _mm256_permute4x64_epi64(c0, 0b01010101),
+                            0b00000011);
+  b[2] = _mm256_blend_epi32(_mm256_permute4x64_epi64(p[2], 0b10011100),
+                            _mm256_permute4x64_epi64(c0, 0b10101010),
+                            0b11000000);
+  b[3] = _mm256_blend_epi32(_mm256_permute4x64_epi64(p[3], 0b00100001),
+                            _mm256_permute4x64_epi64(c0, 0b11111111),
+                            0b00001100);
+
+  // χ step mapping function, on rows 1..4, computed column-wise
+  c0 = _mm256_xor_si256(b_c0, _mm256_andnot_si256(b[0], b[1]));
+  p[0] = _mm256_xor_si256(b[0], _mm256_andnot_si256(b[1], b[2]));
+  p[1] = _mm256_xor_si256(b[1], _mm256_andnot_si256(b[2], b[3]));
+  p[2] = _mm256_xor_si256(b[2], _mm256_andnot_si256(b[3], b_c0));
+  p[3] = _mm256_xor_si256(b[3], _mm256_andnot_si256(b_c0, b[0]));
+
+  // χ step mapping function, on row 0
+  const auto b_x1 = _mm256_blend_epi32(
+    _mm256_permute4x64_epi64(b_r0, 0b00111001), a00, 0b11000000);
+  const auto b_x2 = _mm256_blend_epi32(
+    _mm256_permute4x64_epi64(b_r0, 0b00001110), a00, 0b00110000);
+
+  const auto b_1 = _mm256_permute4x64_epi64(b_r0, 0b00000000);
+  const auto b_2 = _mm256_permute4x64_epi64(b_r0, 0b01010101);
+
+  r0 = _mm256_xor_si256(b_r0, _mm256_andnot_si256(b_x1, b_x2));
+  a00 = _mm256_xor_si256(a00, _mm256_andnot_si256(b_1, b_2));
+
+  // ι step mapping function
+  const auto rc_i = _mm256_set1_epi64x(static_cast<long long>(RC[ridx]));
+  a00 = _mm256_xor_si256(a00, rc_i);
+
+  // p[x-1] holds lanes (x, 1..4) of column x, transpose it back into rows
+  const auto t0 = _mm256_unpacklo_epi64(p[0], p[1]);
+  const auto t1 = _mm256_unpackhi_epi64(p[0], p[1]);
+  const auto t2 = _mm256_unpacklo_epi64(p[2], p[3]);
+  const auto t3 = _mm256_unpackhi_epi64(p[2], p[3]);
+
+  p[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+  p[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+  p[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+  p[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// Keccak-p[1600, nr] permutation, applying last `rounds` rounds of permutation
+// on a single state, which is kept in seven 256 -bit registers, across all
+// rounds. See
+// `round_avx2` for description of register layout.
+//
+// This function is used in place of the scalar permutation, by all hashers and
+// xofs, when this library is compiled with `KECCAK_USE_AVX2` defined, on a
+// target with AVX2 support, or when it's picked by runtime dispatch. Caller
+// must ensure that executing CPU supports AVX2.
+template<size_t rounds = ROUNDS>
+KECCAK_TARGET("avx2") inline void
+permute_avx2(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+  // ρ step rotation offsets, in register layout
+  const __m256i rot[6]{
+    _mm256_setr_epi64x(ROT[1], ROT[2], ROT[3], ROT[4]),
+    _mm256_setr_epi64x(ROT[5], ROT[10], ROT[15], ROT[20]),
+    _mm256_setr_epi64x(ROT[6], ROT[7], ROT[8], ROT[9]),
+    _mm256_setr_epi64x(ROT[11], ROT[12], ROT[13], ROT[14]),
+    _mm256_setr_epi64x(ROT[16], ROT[17], ROT[18], ROT[19]),
+    _mm256_setr_epi64x(ROT[21], ROT[22], ROT[23], ROT[24]),
+  };
+
+  auto a00 = _mm256_set1_epi64x(static_cast<long long>(state[0]));
+  auto r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 1));
+  auto c0 = _mm256_setr_epi64x(static_cast<long long>(state[5]),
+                               static_cast<long long>(state[10]),
+                               static_cast<long long>(state[15]),
+                               static_cast<long long>(state[20]));
+
+  __m256i p[4];
+  for (size_t i = 0; i < 4; i++) {
+    const auto ptr = reinterpret_cast<const __m256i*>(state + (i + 1) * 5 + 1);
+    p[i] = _mm256_loadu_si256(ptr);
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_avx2(a00, r0, c0, p, rot, i);
+  }
+
+  uint64_t col[4];
+
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(col), c0);
+  state[0] = static_cast<uint64_t>(_mm256_extract_epi64(a00, 0));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 1), r0);
+
+  for (size_t i = 0; i < 4; i++) {
+    auto ptr = reinterpret_cast<__m256i*>(state + (i + 1) * 5 + 1);
+    _mm256_storeu_si256(ptr, p[i]);
+    state[(i + 1) * 5] = col[i];
+  }
+}
+
+#endif
+
+// Keccak-p[1600, nr] permutation, using one of the portable kernels, chosen at
+// compile-time, which is also what is used during constant evaluation.
+template<size_t rounds = ROUNDS>
+inline constexpr void
+permute_scalar(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_USE_COMPACT
+  permute_compact<rounds>(state);
+#elif defined KECCAK_USE_LANE_COMPLEMENTING
+  permute_lc<rounds>(state);
+#elif defined KECCAK_USE_ROUNDX4 || (defined __APPLE__ && defined __aarch64__)
+  permute_roundx4<rounds>(state);
+#else // On everywhere else
+  permute_roundx2<rounds>(state);
+#endif
+}
+
+// Name of the portable kernel, used by `permute_scalar`.
+#if defined KECCAK_USE_COMPACT
+static constexpr std::string_view SCALAR_KERNEL = "compact";
+#elif defined KECCAK_USE_LANE_COMPLEMENTING
+static constexpr std::string_view SCALAR_KERNEL = "lc";
+#elif defined KECCAK_USE_ROUNDX4 || (defined __APPLE__ && defined __aarch64__)
+static constexpr std::string_view SCALAR_KERNEL = "roundx4";
+#else
+static constexpr std::string_view SCALAR_KERNEL = "roundx2";
 #endif
+
+using permute_fn_t = void (*)(uint64_t*);
+
+// Single state Keccak-p[1600, nr] permutation kernels, which can be picked at
+// runtime, ordered from most to least preferred. Portable kernel used by
+// `permute_scalar` is preferred over other portable kernels.
+template<size_t rounds = ROUNDS>
+inline std::span<const kernel_t<permute_fn_t>>
+permute_kernels()
+  requires(check_rounds(rounds))
+{
+  static const kernel_t<permute_fn_t> kernels[]{
+#if defined KECCAK_X86_64
+    { "avx2", permute_avx2<rounds>, cpu_features().avx2 },
+#endif
+    { SCALAR_KERNEL, permute_scalar<rounds>, true },
+    { "roundx2", permute_roundx2<rounds>, true },
+    { "roundx4", permute_roundx4<rounds>, true },
+    { "lc", permute_lc<rounds>, true },
+    { "compact", permute_compact<rounds>, true },
+  };
+
+  return kernels;
+}
+
+// Selects single state Keccak-p[1600, nr] permutation kernel, only once, on
+// first call. Best kernel supported by the CPU is selected, unless environment
+// variable `KECCAK_KERNEL` names some other supported kernel.
+template<size_t rounds = ROUNDS>
+inline const kernel_t<permute_fn_t>&
+permute_kernel()
+  requires(check_rounds(rounds))
+{
+  static const auto& kernel =
+    select_kernel(permute_kernels<rounds>(), "KECCAK_KERNEL");
+  return kernel;
+}
+
+// Name of the kernel, used by `permute`, when not constant evaluated.
+inline std::string_view
+permute_kernel_name()
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_kernel().name;
+#elif defined KECCAK_USE_AVX2 && defined __AVX2__
+  return "avx2";
+#else
+  return SCALAR_KERNEL;
+#endif
+}
+
+// Whether `permute` is backed by the lane complementing kernel, when not
+// constant evaluated, so that full message blocks can be absorbed using
+// `absorb_blocks_lc`, which fuses XOR-ing of each block with the permutation.
+// With runtime dispatch, selected kernel is identified by its function
+// pointer, otherwise it's known during compilation.
+template<size_t rounds = ROUNDS>
+inline bool
+permute_is_lc()
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  const auto fn = permute_kernel<rounds>().fn;
+
+  if constexpr (SCALAR_KERNEL == "lc") {
+    if (fn == permute_scalar<rounds>) {
+      return true;
+    }
+  }
+  return fn == permute_lc<rounds>;
+#elif defined KECCAK_USE_AVX2 && defined __AVX2__
+  return false;
+#else
+  return SCALAR_KERNEL == "lc";
+#endif
+}
+
+// Keccak-p[1600, nr] permutation, applying last `rounds` ( = 24, by default )
+// rounds of permutation on state of dimension 5 x 5 x 64 ( = 1600 ) -bits,
+// using algorithm 7 defined in section 3.3 of SHA3 specification
+// https://dx.doi.org/10.6028/NIST.FIPS.202
+//
+// When this library is compiled with `KECCAK_RUNTIME_DISPATCH` defined, kernel
+// is selected at runtime, see `permute_kernel`. Constant evaluation always
+// uses `permute_scalar`.
+template<size_t rounds = ROUNDS>
+inline constexpr void
+permute(uint64_t state[LANE_CNT])
+  requires(check_rounds(rounds))
+{
+  if (!std::is_constant_evaluated()) {
+#if defined KECCAK_RUNTIME_DISPATCH
+    permute_kernel<rounds>().fn(state);
+    return;
+#elif defined KECCAK_USE_AVX2 && defined __AVX2__
+    permute_avx2<rounds>(state);
+    return;
+#endif
+  }
+
+  permute_scalar<rounds>(state);
 }
 
 }
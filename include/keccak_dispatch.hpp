@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+
+// On x86-64, with GCC or Clang, SIMD kernels are compiled using function level
+// target attributes, so that they are available irrespective of `-march` flag,
+// to be picked at runtime, based on features supported by the CPU.
+#if defined __x86_64__ && (defined __GNUC__ || defined __clang__)
+#define KECCAK_X86_64 1
+#define KECCAK_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// Runtime selection of Keccak-p[1600, 24] permutation kernels
+namespace keccak {
+
+// CPU features, which are relevant for selecting a permutation kernel.
+struct cpu_features_t
+{
+  bool avx2 = false;
+  bool avx512f = false;
+};
+
+// Detects CPU features, only once, on first call, using `cpuid`.
+inline const cpu_features_t&
+cpu_features()
+{
+  static const cpu_features_t features = []() {
+    cpu_features_t f{};
+
+#if defined KECCAK_X86_64
+    __builtin_cpu_init();
+
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+
+    return f;
+  }();
+
+  return features;
+}
+
+// A permutation kernel, which can be selected at runtime, given that it's
+// supported by the CPU.
+template<typename fn_t>
+struct kernel_t
+{
+  std::string_view name;
+  fn_t fn;
+  bool supported;
+};
+
+// Given a list of kernels, ordered from most to least preferred, this routine
+// selects the kernel named by environment variable `env`, if it's set and
+// the kernel is supported by the CPU, otherwise it selects the first supported
+// kernel. Last kernel of the list must be always supported.
+template<typename fn_t>
+inline const kernel_t<fn_t>&
+select_kernel(std::span<const kernel_t<fn_t>> kernels, const char* const env)
+{
+  if (const char* const name = std::getenv(env); name != nullptr) {
+    for (const auto& k : kernels) {
+      if (k.supported && k.name == name) {
+        return k;
+      }
+    }
+  }
+
+  for (const auto& k : kernels) {
+    if (k.supported) {
+      return k;
+    }
+  }
+
+  return kernels.back();
+}
+
+}
@@ -0,0 +1,350 @@
+#pragma once
+#include "keccak.hpp"
+
+#if defined KECCAK_X86_64
+#include <immintrin.h>
+#endif
+
+// 2-way batched Keccak-p[1600, 24] permutation
+namespace keccak {
+
+// # -of Keccak-p[1600, 24] permutation states processed together by
+// `permute_x2`
+static constexpr size_t X2_WAYS = 2;
+
+#if defined KECCAK_X86_64
+
+// Leftwards circular rotation of each 64 -bit lane of a 128 -bit vector by `n`
+// (< 64) bit places. Note, when n = 0, right shift by 64 bit places produces
+// 0, so result is the input itself.
+KECCAK_TARGET("sse2") static inline __m128i
+rotl_x2(const __m128i a, const size_t n)
+{
+  const auto t0 = _mm_slli_epi64(a, static_cast<int>(n));
+  const auto t1 = _mm_srli_epi64(a, static_cast<int>(LANE_BW - n));
+  return _mm_or_si128(t0, t1);
+}
+
+// Computes a ^ (~b & c) on each 64 -bit lane, which is what χ step mapping
+// function does to a single lane of the state.
+KECCAK_TARGET("sse2") static inline __m128i
+chi_x2(const __m128i a, const __m128i b, const __m128i c)
+{
+  return _mm_xor_si128(a, _mm_andnot_si128(b, c));
+}
+
+// Keccak-p[1600, 24] round function, applying all five step mapping functions
+// on two interleaved permutation states, held in 25 SSE2 registers s.t. i-th
+// register holds lane `i` of both states.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+KECCAK_TARGET("sse2") static inline void
+round_x2(__m128i* const state, const size_t ridx)
+{
+  __m128i c[5], d[5], b[LANE_CNT];
+
+  // θ step mapping function, computing column parities
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    c[i] = _mm_xor_si128(state[i], state[i + 5]);
+    c[i] = _mm_xor_si128(c[i], state[i + 10]);
+    c[i] = _mm_xor_si128(c[i], state[i + 15]);
+    c[i] = _mm_xor_si128(c[i], state[i + 20]);
+  }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    d[i] = _mm_xor_si128(c[(i + 4) % 5], rotl_x2(c[(i + 1) % 5], 1));
+  }
+
+  // θ, ρ and π step mapping functions, fused together
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 25
+#endif
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const size_t j = PERM[i];
+    b[i] = rotl_x2(_mm_xor_si128(state[j], d[j % 5]), ROT[j]);
+  }
+
+  // χ step mapping function
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < LANE_CNT; i += 5) {
+    state[i + 0] = chi_x2(b[i + 0], b[i + 1], b[i + 2]);
+    state[i + 1] = chi_x2(b[i + 1], b[i + 2], b[i + 3]);
+    state[i + 2] = chi_x2(b[i + 2], b[i + 3], b[i + 4]);
+    state[i + 3] = chi_x2(b[i + 3], b[i + 4], b[i + 0]);
+    state[i + 4] = chi_x2(b[i + 4], b[i + 0], b[i + 1]);
+  }
+
+  // ι step mapping function
+  const auto rc = _mm_set1_epi64x(static_cast<long long>(RC[ridx]));
+  state[0] = _mm_xor_si128(state[0], rc);
+}
+
+// 2-way batched Keccak-p[1600, nr] permutation, permuting both states
+// together, holding each lane in a 128 -bit register. Only SSE2 is used, which
+// is part of x86-64 baseline, so it's always supported.
+template<size_t rounds = ROUNDS>
+KECCAK_TARGET("sse2") inline void
+permute_x2_sse2(uint64_t state[LANE_CNT * X2_WAYS])
+  requires(check_rounds(rounds))
+{
+  __m128i s[LANE_CNT];
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const auto ptr = reinterpret_cast<const __m128i*>(state + i * X2_WAYS);
+    s[i] = _mm_loadu_si128(ptr);
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_x2(s, i);
+  }
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    auto ptr = reinterpret_cast<__m128i*>(state + i * X2_WAYS);
+    _mm_storeu_si128(ptr, s[i]);
+  }
+}
+
+#endif
+
+// Index of lanes of a state, permuted in-place by `roundx4`, at the start of
+// each of the four rounds it applies. Row `r` lists lanes in the order they're
+// fed into χ of round `ridx + r`, five lanes ( = a plane of π's output ) at a
+// time, and χ writes its output back to the very same indices. After four
+// rounds, each lane is back at its own index.
+static constexpr std::array<std::array<size_t, LANE_CNT>, 4> ROUNDX4_LANES{ {
+  { 0, 6, 12, 18, 24, 10, 16, 22, 3, 9, 20, 1, 7,
+    13, 19, 5, 11, 17, 23, 4, 15, 21, 2, 8, 14 },
+  { 0, 16, 7, 23, 14, 20, 11, 2, 18, 9, 15, 6, 22,
+    13, 4, 10, 1, 17, 8, 24, 5, 21, 12, 3, 19 },
+  { 0, 11, 22, 8, 19, 15, 1, 12, 23, 9, 5, 16, 2,
+    13, 24, 20, 6, 17, 3, 14, 10, 21, 7, 18, 4 },
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+    13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 },
+} };
+
+// Offset of χ input, the first lane of each plane of π's output is placed at,
+// so that χ reads lanes of a plane in the order they're listed in
+// `ROUNDX4_LANES`.
+static constexpr std::array<size_t, 5> ROUNDX4_CHI_OFF{ 0, 2, 4, 1, 3 };
+
+// Keccak-p[1600, 24] round function, applying round `ridx` on two independent,
+// lane-interleaved, states, s.t. round `ridx` is the `r` -th of four rounds
+// applied by `roundx4`, hence lanes are laid out as `roundx4` would have them,
+// see `ROUNDX4_LANES`. Each step mapping function is applied on both states,
+// lane by lane, before moving onto the next one, so that two independent
+// dependency chains are interleaved within each step. Lanes are permuted
+// in-place, as done by `roundx4`, so the working set is five lanes of π's
+// output and five θ effects, per state.
+template<size_t r>
+static inline void
+roundx4_x2(uint64_t* const state, const size_t ridx)
+{
+  constexpr auto& pos = ROUNDX4_LANES[r];
+  constexpr auto& rot = ROUNDX4_LANES[0];
+
+  uint64_t c0[5]{}, c1[5]{}, d0[5], d1[5], b0[5], b1[5];
+
+  // θ step mapping function, computing column parities
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 25
+#endif
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    c0[i % 5] ^= state[i * X2_WAYS + 0];
+    c1[i % 5] ^= state[i * X2_WAYS + 1];
+  }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    d0[i] = c0[(i + 4) % 5] ^ std::rotl(c0[(i + 1) % 5], 1);
+    d1[i] = c1[(i + 4) % 5] ^ std::rotl(c1[(i + 1) % 5], 1);
+  }
+
+  // θ, ρ, π and χ step mapping functions, fused together, a plane at a time
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t y = 0; y < 5; y++) {
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+    for (size_t x = 0; x < 5; x++) {
+      const size_t i = y * 5 + x;
+      const size_t j = (x + ROUNDX4_CHI_OFF[y]) % 5;
+
+      b0[j] = std::rotl(state[pos[i] * X2_WAYS + 0] ^ d0[x], ROT[rot[i]]);
+      b1[j] = std::rotl(state[pos[i] * X2_WAYS + 1] ^ d1[x], ROT[rot[i]]);
+    }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+    for (size_t x = 0; x < 5; x++) {
+      const size_t i = y * 5 + x;
+
+      const uint64_t t0 = b0[x] ^ (~b0[(x + 1) % 5] & b0[(x + 2) % 5]);
+      const uint64_t t1 = b1[x] ^ (~b1[(x + 1) % 5] & b1[(x + 2) % 5]);
+
+      state[pos[i] * X2_WAYS + 0] = t0;
+      state[pos[i] * X2_WAYS + 1] = t1;
+    }
+  }
+
+  // ι step mapping function
+  state[0] ^= RC[ridx];
+  state[1] ^= RC[ridx];
+}
+
+// 2-way batched Keccak-p[1600, nr] permutation, on general purpose registers,
+// advancing both states in a single instruction stream. A single state doesn't
+// saturate an out-of-order core, as θ and χ form long dependency chains, so
+// each step of each round is applied on both states, lane by lane, see
+// `roundx4_x2`, letting the compiler interleave two independent chains at
+// instruction granularity. States are permuted right where they are, as
+// de-interleaving them into local arrays gets vectorized, stalling on store
+// forwarding, when lanes are read back one by one. Leading rounds, when number
+// of rounds is not a multiple of four, are applied on each state alone.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x2_scalar(uint64_t state[LANE_CNT * X2_WAYS])
+  requires(check_rounds(rounds))
+{
+  constexpr size_t start = ROUNDS - rounds;
+
+  if constexpr (rounds % 4 != 0) {
+    uint64_t s0[LANE_CNT], s1[LANE_CNT];
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      s0[i] = state[i * X2_WAYS + 0];
+      s1[i] = state[i * X2_WAYS + 1];
+    }
+
+    for (size_t i = start; i < start + rounds % 4; i++) {
+      roundx1(s0, i);
+      roundx1(s1, i);
+    }
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      state[i * X2_WAYS + 0] = s0[i];
+      state[i * X2_WAYS + 1] = s1[i];
+    }
+  }
+
+  for (size_t i = start + rounds % 4; i < ROUNDS; i += 4) {
+    roundx4_x2<0>(state, i + 0);
+    roundx4_x2<1>(state, i + 1);
+    roundx4_x2<2>(state, i + 2);
+    roundx4_x2<3>(state, i + 3);
+  }
+}
+
+// 2-way batched Keccak-p[1600, nr] permutation kernels, which can be picked at
+// runtime, ordered from most to least preferred.
+template<size_t rounds = ROUNDS>
+inline std::span<const kernel_t<permute_fn_t>>
+permute_x2_kernels()
+  requires(check_rounds(rounds))
+{
+  static const kernel_t<permute_fn_t> kernels[]{
+#if defined KECCAK_X86_64
+    { "sse2", permute_x2_sse2<rounds>, true },
+#endif
+    { "scalar", permute_x2_scalar<rounds>, true },
+  };
+
+  return kernels;
+}
+
+// Selects 2-way batched Keccak-p[1600, nr] permutation kernel, only once, on
+// first call, honouring environment variable `KECCAK_X2_KERNEL`.
+template<size_t rounds = ROUNDS>
+inline const kernel_t<permute_fn_t>&
+permute_x2_kernel()
+  requires(check_rounds(rounds))
+{
+  static const auto& kernel =
+    select_kernel(permute_x2_kernels<rounds>(), "KECCAK_X2_KERNEL");
+  return kernel;
+}
+
+// Name of the kernel, used by `permute_x2`.
+inline std::string_view
+permute_x2_kernel_name()
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x2_kernel().name;
+#elif defined KECCAK_X86_64 && defined __SSE2__
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+// Whether `permute_x2<rounds>` is backed by a SIMD kernel, see
+// `permute_x4_is_simd`.
+template<size_t rounds = ROUNDS>
+inline bool
+permute_x2_is_simd()
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x2_kernel<rounds>().fn != permute_x2_scalar<rounds>;
+#elif defined KECCAK_X86_64 && defined __SSE2__
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 2-way batched Keccak-p[1600, nr] permutation, applying last `rounds` rounds
+// of permutation on two independent states, which are kept lane-interleaved
+// in memory i.e. lane `i` of state `j` lives at index `i * 2 + j` of `state`.
+//
+// Result is bit-identical to applying `permute<rounds>` on each of two states.
+// On x86-64, both states are permuted together, holding each lane in a 128
+// -bit register, using only SSE2, otherwise both are permuted on general
+// purpose registers, interleaved, see `permute_x2_scalar`. When compiled with
+// `KECCAK_RUNTIME_DISPATCH` defined, kernel is selected at runtime, see
+// `permute_x2_kernel`.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x2(uint64_t state[LANE_CNT * X2_WAYS])
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  permute_x2_kernel<rounds>().fn(state);
+#elif defined KECCAK_X86_64 && defined __SSE2__
+  permute_x2_sse2<rounds>(state);
+#else
+  permute_x2_scalar<rounds>(state);
+#endif
+}
+
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include "keccak.hpp"
+
+#if defined KECCAK_X86_64
+#include <immintrin.h>
+#endif
+
+// 4-way batched Keccak-p[1600, 24] permutation
+namespace keccak {
+
+// # -of Keccak-p[1600, 24] permutation states processed together by
+// `permute_x4`
+static constexpr size_t X4_WAYS = 4;
+
+#if defined KECCAK_X86_64
+
+// Leftwards circular rotation of each 64 -bit lane of a 256 -bit vector by `n`
+// (< 64) bit places. Note, when n = 0, right shift by 64 bit places produces
+// 0, so result is the input itself.
+KECCAK_TARGET("avx2") static inline __m256i
+rotl_x4(const __m256i a, const size_t n)
+{
+  const auto t0 = _mm256_slli_epi64(a, static_cast<int>(n));
+  const auto t1 = _mm256_srli_epi64(a, static_cast<int>(LANE_BW - n));
+  return _mm256_or_si256(t0, t1);
+}
+
+// Computes a ^ (~b & c) on each 64 -bit lane, which is what χ step mapping
+// function does to a single lane of the state.
+KECCAK_TARGET("avx2") static inline __m256i
+chi_x4(const __m256i a, const __m256i b, const __m256i c)
+{
+  return _mm256_xor_si256(a, _mm256_andnot_si256(b, c));
+}
+
+// Keccak-p[1600, 24] round function, applying all five step mapping functions
+// on four interleaved permutation states, held in 25 AVX2 registers s.t. i-th
+// register holds lane `i` of all four states.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+KECCAK_TARGET("avx2") static inline void
+round_x4(__m256i* const state, const size_t ridx)
+{
+  __m256i c[5], d[5], b[LANE_CNT];
+
+  // θ step mapping function, computing column parities
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    c[i] = _mm256_xor_si256(state[i], state[i + 5]);
+    c[i] = _mm256_xor_si256(c[i], state[i + 10]);
+    c[i] = _mm256_xor_si256(c[i], state[i + 15]);
+    c[i] = _mm256_xor_si256(c[i], state[i + 20]);
+  }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    d[i] = _mm256_xor_si256(c[(i + 4) % 5], rotl_x4(c[(i + 1) % 5], 1));
+  }
+
+  // θ, ρ and π step mapping functions, fused together
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 25
+#endif
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const size_t j = PERM[i];
+    b[i] = rotl_x4(_mm256_xor_si256(state[j], d[j % 5]), ROT[j]);
+  }
+
+  // χ step mapping function
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < LANE_CNT; i += 5) {
+    state[i + 0] = chi_x4(b[i + 0], b[i + 1], b[i + 2]);
+    state[i + 1] = chi_x4(b[i + 1], b[i + 2], b[i + 3]);
+    state[i + 2] = chi_x4(b[i + 2], b[i + 3], b[i + 4]);
+    state[i + 3] = chi_x4(b[i + 3], b[i + 4], b[i + 0]);
+    state[i + 4] = chi_x4(b[i + 4], b[i + 0], b[i + 1]);
+  }
+
+  // ι step mapping function
+  const auto rc = _mm256_set1_epi64x(static_cast<long long>(RC[ridx]));
+  state[0] = _mm256_xor_si256(state[0], rc);
+}
+
+// 4-way batched Keccak-p[1600, nr] permutation, permuting all four states
+// together, holding each lane in a 256 -bit register. Caller must ensure that
+// executing CPU supports AVX2.
+template<size_t rounds = ROUNDS>
+KECCAK_TARGET("avx2") inline void
+permute_x4_avx2(uint64_t state[LANE_CNT * X4_WAYS])
+  requires(check_rounds(rounds))
+{
+  __m256i s[LANE_CNT];
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const auto ptr = reinterpret_cast<const __m256i*>(state + i * X4_WAYS);
+    s[i] = _mm256_loadu_si256(ptr);
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_x4(s, i);
+  }
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    auto ptr = reinterpret_cast<__m256i*>(state + i * X4_WAYS);
+    _mm256_storeu_si256(ptr, s[i]);
+  }
+}
+
+#endif
+
+// 4-way batched Keccak-p[1600, nr] permutation, falling back to applying
+// `permute` on each of four states, one after another.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x4_scalar(uint64_t state[LANE_CNT * X4_WAYS])
+  requires(check_rounds(rounds))
+{
+  uint64_t s[LANE_CNT];
+
+  for (size_t j = 0; j < X4_WAYS; j++) {
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      s[i] = state[i * X4_WAYS + j];
+    }
+
+    permute<rounds>(s);
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      state[i * X4_WAYS + j] = s[i];
+    }
+  }
+}
+
+// 4-way batched Keccak-p[1600, nr] permutation kernels, which can be picked at
+// runtime, ordered from most to least preferred.
+template<size_t rounds = ROUNDS>
+inline std::span<const kernel_t<permute_fn_t>>
+permute_x4_kernels()
+  requires(check_rounds(rounds))
+{
+  static const kernel_t<permute_fn_t> kernels[]{
+#if defined KECCAK_X86_64
+    { "avx2", permute_x4_avx2<rounds>, cpu_features().avx2 },
+#endif
+    { "scalar", permute_x4_scalar<rounds>, true },
+  };
+
+  return kernels;
+}
+
+// Selects 4-way batched Keccak-p[1600, nr] permutation kernel, only once, on
+// first call, honouring environment variable `KECCAK_X4_KERNEL`.
+template<size_t rounds = ROUNDS>
+inline const kernel_t<permute_fn_t>&
+permute_x4_kernel()
+  requires(check_rounds(rounds))
+{
+  static const auto& kernel =
+    select_kernel(permute_x4_kernels<rounds>(), "KECCAK_X4_KERNEL");
+  return kernel;
+}
+
+// Name of the kernel, used by `permute_x4`.
+inline std::string_view
+permute_x4_kernel_name()
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x4_kernel().name;
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  return "avx2";
+#else
+  return "scalar";
+#endif
+}
+
+// Whether `permute_x4<rounds>` is backed by a SIMD kernel, so that callers
+// can pick a batched permutation without comparing kernel names. With runtime
+// dispatch, selected kernel is identified by its function pointer.
+template<size_t rounds = ROUNDS>
+inline bool
+permute_x4_is_simd()
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x4_kernel<rounds>().fn != permute_x4_scalar<rounds>;
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 4-way batched Keccak-p[1600, nr] permutation, applying last `rounds` rounds
+// of permutation on four independent states, which are kept lane-interleaved
+// in memory i.e. lane `i` of state `j` lives at index `i * 4 + j` of `state`.
+//
+// Result is bit-identical to applying `permute<rounds>` on each of four
+// states. On targets with AVX2, all four states are permuted together, holding
+// each lane in a 256 -bit register, otherwise it falls back to the scalar
+// permutation. When compiled with `KECCAK_RUNTIME_DISPATCH` defined, kernel is
+// selected at runtime, see `permute_x4_kernel`.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x4(uint64_t state[LANE_CNT * X4_WAYS])
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  permute_x4_kernel<rounds>().fn(state);
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  permute_x4_avx2<rounds>(state);
+#else
+  permute_x4_scalar<rounds>(state);
+#endif
+}
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include "keccak_x4.hpp"
+
+// 5-way batched Keccak-p[1600, 24] permutation, mixing SIMD and scalar lanes
+namespace keccak {
+
+// # -of Keccak-p[1600, 24] permutation states processed together by
+// `permute_x5`
+static constexpr size_t X5_WAYS = 5;
+
+#if defined KECCAK_X86_64
+
+// 5-way batched Keccak-p[1600, nr] permutation, permuting first four states
+// together, holding each lane in a 256 -bit register, while fifth state is
+// permuted on general purpose registers. Both are advanced round by round, in
+// the same loop body, so that the compiler can interleave vector and scalar
+// instructions, keeping scalar ALUs busy, which otherwise idle while AVX2
+// kernel runs. Caller must ensure that executing CPU supports AVX2.
+template<size_t rounds = ROUNDS>
+KECCAK_TARGET("avx2") inline void
+permute_x5_avx2(uint64_t state[LANE_CNT * X5_WAYS])
+  requires(check_rounds(rounds))
+{
+  __m256i s[LANE_CNT];
+  uint64_t t[LANE_CNT];
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const auto ptr = reinterpret_cast<const __m256i*>(state + i * X5_WAYS);
+    s[i] = _mm256_loadu_si256(ptr);
+    t[i] = state[i * X5_WAYS + X4_WAYS];
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_x4(s, i);
+    roundx1(t, i);
+  }
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    auto ptr = reinterpret_cast<__m256i*>(state + i * X5_WAYS);
+    _mm256_storeu_si256(ptr, s[i]);
+    state[i * X5_WAYS + X4_WAYS] = t[i];
+  }
+}
+
+#endif
+
+// 5-way batched Keccak-p[1600, nr] permutation, falling back to applying
+// `permute` on each of five states, one after another.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x5_scalar(uint64_t state[LANE_CNT * X5_WAYS])
+  requires(check_rounds(rounds))
+{
+  uint64_t s[LANE_CNT];
+
+  for (size_t j = 0; j < X5_WAYS; j++) {
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      s[i] = state[i * X5_WAYS + j];
+    }
+
+    permute<rounds>(s);
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      state[i * X5_WAYS + j] = s[i];
+    }
+  }
+}
+
+// 5-way batched Keccak-p[1600, nr] permutation kernels, which can be picked at
+// runtime, ordered from most to least preferred.
+template<size_t rounds = ROUNDS>
+inline std::span<const kernel_t<permute_fn_t>>
+permute_x5_kernels()
+  requires(check_rounds(rounds))
+{
+  static const kernel_t<permute_fn_t> kernels[]{
+#if defined KECCAK_X86_64
+    { "avx2", permute_x5_avx2<rounds>, cpu_features().avx2 },
+#endif
+    { "scalar", permute_x5_scalar<rounds>, true },
+  };
+
+  return kernels;
+}
+
+// Selects 5-way batched Keccak-p[1600, nr] permutation kernel, only once, on
+// first call, honouring environment variable `KECCAK_X5_KERNEL`.
+template<size_t rounds = ROUNDS>
+inline const kernel_t<permute_fn_t>&
+permute_x5_kernel()
+  requires(check_rounds(rounds))
+{
+  static const auto& kernel =
+    select_kernel(permute_x5_kernels<rounds>(), "KECCAK_X5_KERNEL");
+  return kernel;
+}
+
+// Name of the kernel, used by `permute_x5`.
+inline std::string_view
+permute_x5_kernel_name()
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x5_kernel().name;
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  return "avx2";
+#else
+  return "scalar";
+#endif
+}
+
+// Whether `permute_x5<rounds>` is backed by a SIMD kernel, see
+// `permute_x4_is_simd`.
+template<size_t rounds = ROUNDS>
+inline bool
+permute_x5_is_simd()
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x5_kernel<rounds>().fn != permute_x5_scalar<rounds>;
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 5-way batched Keccak-p[1600, nr] permutation, applying last `rounds` rounds
+// of permutation on five independent states, which are kept lane-interleaved
+// in memory i.e. lane `i` of state `j` lives at index `i * 5 + j` of `state`.
+//
+// Result is bit-identical to applying `permute<rounds>` on each of five
+// states. On targets with AVX2, four states are permuted on SIMD lanes and
+// the fifth one on scalar lanes, in one interleaved instruction stream,
+// otherwise it falls back to the scalar permutation. When compiled with
+// `KECCAK_RUNTIME_DISPATCH` defined, kernel is selected at runtime, see
+// `permute_x5_kernel`.
+//
+// Note, per state, it's slower than `permute_x4`, as scalar lanes can't keep
+// up with SIMD lanes, but it's faster than `permute_x4` followed by `permute`,
+// which is what hashing five messages costs otherwise.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x5(uint64_t state[LANE_CNT * X5_WAYS])
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  permute_x5_kernel<rounds>().fn(state);
+#elif defined KECCAK_X86_64 && defined __AVX2__
+  permute_x5_avx2<rounds>(state);
+#else
+  permute_x5_scalar<rounds>(state);
+#endif
+}
+
+}
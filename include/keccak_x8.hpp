@@ -0,0 +1,232 @@
+#pragma once
+#include "keccak.hpp"
+
+#if defined KECCAK_X86_64
+#include <immintrin.h>
+#endif
+
+// 8-way batched Keccak-p[1600, 24] permutation
+namespace keccak {
+
+// # -of Keccak-p[1600, 24] permutation states processed together by
+// `permute_x8`
+static constexpr size_t X8_WAYS = 8;
+
+#if defined KECCAK_X86_64
+
+// Truth table of a ^ b ^ c, for use with `vpternlogq`.
+static constexpr int XOR3 = 0x96;
+
+// Truth table of a ^ (~b & c), for use with `vpternlogq`, which is what χ
+// step mapping function does to a single lane of the state.
+static constexpr int CHI = 0xd2;
+
+// Leftwards circular rotation of each 64 -bit lane of a 512 -bit vector by `n`
+// bit places, using `vprolq`. Note, zero-masking form with all mask bits set
+// is used, which compiles to same instruction, while avoiding spurious
+// -Wuninitialized warning, emitted by GCC's AVX-512 intrinsics header.
+template<size_t n>
+KECCAK_TARGET("avx512f") static inline __m512i
+rotl_x8(const __m512i a)
+{
+  return _mm512_maskz_rol_epi64(0xff, a, n);
+}
+
+// Keccak-p[1600, 24] step mapping functions θ ( second half ), ρ and π, fused
+// together, for all 25 lanes of eight interleaved states. Rotation offsets are
+// passed as immediate operands of `vprolq`, so lane indices are expanded at
+// compile-time.
+template<size_t... I>
+KECCAK_TARGET("avx512f") static inline void
+theta_rho_pi_x8(const __m512i* const __restrict state,
+                const __m512i* const __restrict d,
+                __m512i* const __restrict b,
+                std::index_sequence<I...>)
+{
+  ((b[I] = rotl_x8<ROT[PERM[I]]>(
+      _mm512_xor_si512(state[PERM[I]], d[PERM[I] % 5]))),
+   ...);
+}
+
+// Keccak-p[1600, 24] round function, applying all five step mapping functions
+// on eight interleaved permutation states, held in 25 AVX-512 registers s.t.
+// i-th register holds lane `i` of all eight states.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+KECCAK_TARGET("avx512f") static inline void
+round_x8(__m512i* const state, const size_t ridx)
+{
+  __m512i c[5], d[5], b[LANE_CNT];
+
+  // θ step mapping function, computing column parities
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    const auto t = _mm512_ternarylogic_epi64(
+      state[i], state[i + 5], state[i + 10], XOR3);
+    c[i] = _mm512_ternarylogic_epi64(t, state[i + 15], state[i + 20], XOR3);
+  }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    const auto t = rotl_x8<1>(c[(i + 1) % 5]);
+    d[i] = _mm512_xor_si512(c[(i + 4) % 5], t);
+  }
+
+  theta_rho_pi_x8(state, d, b, std::make_index_sequence<LANE_CNT>{});
+
+  // χ step mapping function, one `vpternlogq` per lane
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < LANE_CNT; i += 5) {
+    state[i + 0] = _mm512_ternarylogic_epi64(b[i + 0], b[i + 1], b[i + 2], CHI);
+    state[i + 1] = _mm512_ternarylogic_epi64(b[i + 1], b[i + 2], b[i + 3], CHI);
+    state[i + 2] = _mm512_ternarylogic_epi64(b[i + 2], b[i + 3], b[i + 4], CHI);
+    state[i + 3] = _mm512_ternarylogic_epi64(b[i + 3], b[i + 4], b[i + 0], CHI);
+    state[i + 4] = _mm512_ternarylogic_epi64(b[i + 4], b[i + 0], b[i + 1], CHI);
+  }
+
+  // ι step mapping function
+  const auto rc = _mm512_set1_epi64(static_cast<long long>(RC[ridx]));
+  state[0] = _mm512_xor_si512(state[0], rc);
+}
+
+// 8-way batched Keccak-p[1600, nr] permutation, permuting all eight states
+// together, holding each lane in a 512 -bit register. Caller must ensure that
+// executing CPU supports AVX-512F.
+template<size_t rounds = ROUNDS>
+KECCAK_TARGET("avx512f") inline void
+permute_x8_avx512(uint64_t state[LANE_CNT * X8_WAYS])
+  requires(check_rounds(rounds))
+{
+  __m512i s[LANE_CNT];
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    s[i] = _mm512_loadu_si512(state + i * X8_WAYS);
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_x8(s, i);
+  }
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    _mm512_storeu_si512(state + i * X8_WAYS, s[i]);
+  }
+}
+
+#endif
+
+// 8-way batched Keccak-p[1600, nr] permutation, falling back to applying
+// `permute` on each of eight states, one after another.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x8_scalar(uint64_t state[LANE_CNT * X8_WAYS])
+  requires(check_rounds(rounds))
+{
+  uint64_t s[LANE_CNT];
+
+  for (size_t j = 0; j < X8_WAYS; j++) {
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      s[i] = state[i * X8_WAYS + j];
+    }
+
+    permute<rounds>(s);
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      state[i * X8_WAYS + j] = s[i];
+    }
+  }
+}
+
+// 8-way batched Keccak-p[1600, nr] permutation kernels, which can be picked at
+// runtime, ordered from most to least preferred.
+template<size_t rounds = ROUNDS>
+inline std::span<const kernel_t<permute_fn_t>>
+permute_x8_kernels()
+  requires(check_rounds(rounds))
+{
+  static const kernel_t<permute_fn_t> kernels[]{
+#if defined KECCAK_X86_64
+    { "avx512", permute_x8_avx512<rounds>, cpu_features().avx512f },
+#endif
+    { "scalar", permute_x8_scalar<rounds>, true },
+  };
+
+  return kernels;
+}
+
+// Selects 8-way batched Keccak-p[1600, nr] permutation kernel, only once, on
+// first call, honouring environment variable `KECCAK_X8_KERNEL`.
+template<size_t rounds = ROUNDS>
+inline const kernel_t<permute_fn_t>&
+permute_x8_kernel()
+  requires(check_rounds(rounds))
+{
+  static const auto& kernel =
+    select_kernel(permute_x8_kernels<rounds>(), "KECCAK_X8_KERNEL");
+  return kernel;
+}
+
+// Name of the kernel, used by `permute_x8`.
+inline std::string_view
+permute_x8_kernel_name()
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x8_kernel().name;
+#elif defined KECCAK_X86_64 && defined __AVX512F__
+  return "avx512";
+#else
+  return "scalar";
+#endif
+}
+
+// Whether `permute_x8<rounds>` is backed by a SIMD kernel, see
+// `permute_x4_is_simd`.
+template<size_t rounds = ROUNDS>
+inline bool
+permute_x8_is_simd()
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  return permute_x8_kernel<rounds>().fn != permute_x8_scalar<rounds>;
+#elif defined KECCAK_X86_64 && defined __AVX512F__
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 8-way batched Keccak-p[1600, nr] permutation, applying last `rounds` rounds
+// of permutation on eight independent states, which are kept lane-interleaved
+// in memory i.e. lane `i` of state `j` lives at index `i * 8 + j` of `state`.
+//
+// Result is bit-identical to applying `permute<rounds>` on each of eight
+// states. On targets with AVX-512F, all eight states are permuted together,
+// holding each lane in a 512 -bit register, otherwise it falls back to the
+// scalar permutation. When compiled with `KECCAK_RUNTIME_DISPATCH` defined,
+// kernel is selected at runtime, see `permute_x8_kernel`.
+template<size_t rounds = ROUNDS>
+inline void
+permute_x8(uint64_t state[LANE_CNT * X8_WAYS])
+  requires(check_rounds(rounds))
+{
+#if defined KECCAK_RUNTIME_DISPATCH
+  permute_x8_kernel<rounds>().fn(state);
+#elif defined KECCAK_X86_64 && defined __AVX512F__
+  permute_x8_avx512<rounds>(state);
+#else
+  permute_x8_scalar<rounds>(state);
+#endif
+}
+
+}
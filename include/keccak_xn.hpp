@@ -0,0 +1,169 @@
+#pragma once
+#include "keccak.hpp"
+#include <cstring>
+
+// With GCC or Clang, N-way batched kernel is written once, using generic
+// vector extensions, which are lowered to SIMD instructions of whatever
+// target the compiler is asked to generate code for.
+#if defined __GNUC__ || defined __clang__
+#define KECCAK_VECTOR_EXT 1
+#endif
+
+// N-way batched Keccak-p[1600, 24] permutation, portable across targets
+namespace keccak {
+
+// Compile-time check to ensure that # -of states, permuted together by
+// `permute_xN`, is a power of 2, within [2, 8], so that each lane of all
+// states fits in a vector of at most 512 -bits.
+constexpr bool
+check_ways(const size_t ways)
+{
+  return (ways >= 2) && (ways <= 8) && ((ways & (ways - 1)) == 0);
+}
+
+#if defined KECCAK_VECTOR_EXT
+
+// Vector of `ways` -many 64 -bit lanes, s.t. it holds same lane of all states.
+// Note, GCC ignores `vector_size` attribute when it's put on an alias template,
+// so vector type is declared inside a class template.
+template<size_t ways>
+struct lanes_vec_t
+{
+  typedef uint64_t type __attribute__((vector_size(ways * sizeof(uint64_t))));
+};
+
+template<size_t ways>
+using lanes_t = typename lanes_vec_t<ways>::type;
+
+// Keccak-p[1600, 24] round function, applying all five step mapping functions
+// on `ways` -many interleaved permutation states, held in 25 vectors s.t.
+// i-th vector holds lane `i` of all states.
+//
+// Rotation is spelled out in place, instead of being a function taking and
+// returning vectors, as passing wider than natively supported vectors by
+// value changes the ABI, which compiler warns about.
+//
+// See section 3.3 of https://dx.doi.org/10.6028/NIST.FIPS.202
+template<size_t ways>
+static inline void
+round_xN(lanes_t<ways>* const state, const size_t ridx)
+  requires(check_ways(ways))
+{
+  lanes_t<ways> c[5], d[5], b[LANE_CNT];
+
+  // θ step mapping function, computing column parities
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    c[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^
+           state[i + 20];
+  }
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < 5; i++) {
+    const auto t = c[(i + 1) % 5];
+    d[i] = c[(i + 4) % 5] ^ ((t << 1) | (t >> (LANE_BW - 1)));
+  }
+
+  // θ, ρ and π step mapping functions, fused together. Note, shifting by 64
+  // bit places isn't defined, so rotation by 0 is special cased.
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 25
+#endif
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    const size_t j = PERM[i];
+    const size_t n = ROT[j];
+    const auto t = state[j] ^ d[j % 5];
+
+    b[i] = (n == 0) ? t : ((t << n) | (t >> (LANE_BW - n)));
+  }
+
+  // χ step mapping function
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t i = 0; i < LANE_CNT; i += 5) {
+    state[i + 0] = b[i + 0] ^ (~b[i + 1] & b[i + 2]);
+    state[i + 1] = b[i + 1] ^ (~b[i + 2] & b[i + 3]);
+    state[i + 2] = b[i + 2] ^ (~b[i + 3] & b[i + 4]);
+    state[i + 3] = b[i + 3] ^ (~b[i + 4] & b[i + 0]);
+    state[i + 4] = b[i + 4] ^ (~b[i + 0] & b[i + 1]);
+  }
+
+  // ι step mapping function
+  state[0] ^= RC[ridx];
+}
+
+#endif
+
+// N-way batched Keccak-p[1600, nr] permutation, applying `permute` on each of
+// `ways` -many states, one after another.
+template<size_t ways, size_t rounds = ROUNDS>
+inline void
+permute_xN_scalar(uint64_t state[LANE_CNT * ways])
+  requires(check_ways(ways) && check_rounds(rounds))
+{
+  uint64_t s[LANE_CNT];
+
+  for (size_t j = 0; j < ways; j++) {
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      s[i] = state[i * ways + j];
+    }
+
+    permute<rounds>(s);
+
+    for (size_t i = 0; i < LANE_CNT; i++) {
+      state[i * ways + j] = s[i];
+    }
+  }
+}
+
+// N-way batched Keccak-p[1600, nr] permutation, applying last `rounds` rounds
+// of permutation on `ways` -many independent states, which are kept
+// lane-interleaved in memory i.e. lane `i` of state `j` lives at index
+// `i * ways + j` of `state`. Memory layout is same as `permute_x{2, 4, 8}`.
+//
+// Result is bit-identical to applying `permute<rounds>` on each of the states.
+// With GCC or Clang, it's written using generic vector extensions, so that
+// one implementation gets compiled to SSE2, AVX2, AVX-512, NEON etc., as
+// enabled by `-march` flag, while vectors wider than what target supports are
+// split into narrower ones. Otherwise it falls back to `permute_xN_scalar`.
+// Unlike `permute_x{2, 4, 8}`, there's no runtime dispatch, instruction set is
+// fixed at compile-time.
+template<size_t ways, size_t rounds = ROUNDS>
+inline void
+permute_xN(uint64_t state[LANE_CNT * ways])
+  requires(check_ways(ways) && check_rounds(rounds))
+{
+#if defined KECCAK_VECTOR_EXT
+  static_assert(sizeof(lanes_t<ways>) == ways * sizeof(uint64_t));
+  lanes_t<ways> s[LANE_CNT];
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    std::memcpy(&s[i], state + i * ways, sizeof(s[i]));
+  }
+
+  for (size_t i = ROUNDS - rounds; i < ROUNDS; i++) {
+    round_xN<ways>(s, i);
+  }
+
+  for (size_t i = 0; i < LANE_CNT; i++) {
+    std::memcpy(state + i * ways, &s[i], sizeof(s[i]));
+  }
+#else
+  permute_xN_scalar<ways, rounds>(state);
+#endif
+}
+
+}
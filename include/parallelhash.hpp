@@ -0,0 +1,309 @@
+#pragma once
+#include "shake128.hpp"
+#include "shake256.hpp"
+#include "sponge_batched.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// ParallelHash{128, 256} : cSHAKE{128, 256} over chaining values of
+// fixed-size message blocks, each hashed independently using SHAKE{128, 256}
+namespace parallelhash {
+
+// Function name string N = "ParallelHash", used for customizing cSHAKE.
+constexpr std::array<uint8_t, 12> FUNCTION_NAME{ 'P', 'a', 'r', 'a', 'l', 'l',
+                                                 'e', 'l', 'H', 'a', 's', 'h' };
+
+// Domain separator bits, used for finalizing cSHAKE.
+constexpr uint8_t CSHAKE_DOM_SEP = 0b00000000;
+
+// Bit-width of cSHAKE domain separator, starting from least significant bit.
+constexpr size_t CSHAKE_DOM_SEP_BW = 2;
+
+// Domain separation byte, used for finalizing SHAKE sponge of each block, holds
+// SHAKE domain separator bits, followed by first bit of 10*1 padding.
+constexpr uint8_t BLOCK_DOM_SEP =
+  (1 << shake128::DOM_SEP_BW) | shake128::DOM_SEP;
+
+// Compile-time check to ensure that ParallelHash is instantiated with capacity
+// of either SHAKE128 or SHAKE256.
+constexpr bool
+check_capacity(const size_t capacity)
+{
+  return (capacity == shake128::CAPACITY) | (capacity == shake256::CAPACITY);
+}
+
+// Encodes `x` as big-endian byte string with no leading zero bytes ( but at
+// least one byte ), preceded by a single byte holding its length, writing
+// result into `enc` and returning number of bytes written.
+//
+// See section 2.3.1 of SP 800-185 https://doi.org/10.6028/NIST.SP.800-185
+static inline constexpr size_t
+left_encode(size_t x, std::span<uint8_t, sizeof(size_t) + 1> enc)
+{
+  constexpr size_t max_len = sizeof(size_t);
+
+  size_t len = 1;
+  while ((len < max_len) && ((x >> (len * 8)) != 0)) {
+    len++;
+  }
+
+  enc[0] = static_cast<uint8_t>(len);
+  for (size_t i = 0; i < max_len; i++) {
+    if (i < len) {
+      enc[i + 1] = static_cast<uint8_t>(x >> ((len - 1 - i) * 8));
+    }
+  }
+
+  return len + 1;
+}
+
+// Same as above, but length byte follows big-endian encoding of `x`.
+//
+// See section 2.3.1 of SP 800-185 https://doi.org/10.6028/NIST.SP.800-185
+static inline constexpr size_t
+right_encode(size_t x, std::span<uint8_t, sizeof(size_t) + 1> enc)
+{
+  constexpr size_t max_len = sizeof(size_t);
+
+  size_t len = 1;
+  while ((len < max_len) && ((x >> (len * 8)) != 0)) {
+    len++;
+  }
+
+  for (size_t i = 0; i < max_len; i++) {
+    if (i < len) {
+      enc[i] = static_cast<uint8_t>(x >> ((len - 1 - i) * 8));
+    }
+  }
+  enc[len] = static_cast<uint8_t>(len);
+
+  return len + 1;
+}
+
+// ParallelHash{128, 256}, parameterized by capacity of the underlying Keccak
+// sponges, which splits message X into B -bytes blocks, hashes each of them
+// independently, using SHAKE{128, 256} producing c/8 -bytes chaining values,
+// batched on SIMD lanes and spread across worker threads, while chaining
+// values are absorbed into cSHAKE{128, 256}( left_encode(B) || CV_0 || ... ||
+// CV_{n-1} || right_encode(n) || right_encode(L), L, "ParallelHash", S ).
+// Output doesn't depend on number of threads.
+//
+// See section 6 of SP 800-185 https://doi.org/10.6028/NIST.SP.800-185
+template<size_t capacity>
+  requires(check_capacity(capacity))
+struct parallelhash_t
+{
+public:
+  // Width of rate portion of the sponges, in bits.
+  static constexpr size_t RATE = 1600 - capacity;
+
+  // Byte length of chaining value, computed for each block.
+  static constexpr size_t CV_LEN = capacity / 8;
+
+private:
+  // cSHAKE sponge, absorbing chaining values of blocks
+  uint64_t state[keccak::LANE_CNT]{};
+  size_t offset = 0;
+  size_t squeezable = 0;
+
+  // cSHAKE sponge state, right after absorbing bytepad(encode_string(N) ||
+  // encode_string(S), rate/ 8) || left_encode(B), for resetting
+  uint64_t init_state[keccak::LANE_CNT]{};
+  size_t init_offset = 0;
+
+  // Partially filled block
+  std::vector<uint8_t> blk_buf{};
+  size_t blk_len = 0;
+
+  size_t blk_cnt = 0; // # -of blocks absorbed into cSHAKE sponge
+  alignas(4) bool finalized = false; // all message bytes absorbed ?
+
+  // Worker threads used for hashing blocks, kept alive across absorb calls
+  std::unique_ptr<sha3_utils::worker_pool_t> pool;
+
+  // Absorbs bytes into cSHAKE sponge.
+  inline void absorb_cshake(std::span<const uint8_t> bytes)
+  {
+    sponge::absorb<RATE>(state, offset, bytes);
+  }
+
+  // Absorbs encoding of `x`, computed using either left_encode or
+  // right_encode, into cSHAKE sponge.
+  template<size_t (*encode)(size_t, std::span<uint8_t, sizeof(size_t) + 1>)>
+  inline void absorb_encoded(const size_t x)
+  {
+    std::array<uint8_t, sizeof(size_t) + 1> enc{};
+    const size_t enc_len = encode(x, enc);
+
+    absorb_cshake(std::span(enc).first(enc_len));
+  }
+
+public:
+  // Creates a ParallelHash hasher, which splits message into `block_len` -bytes
+  // blocks, s.t. `block_len` > 0, as asserted, customized using ( possibly
+  // empty ) string S and hashes blocks using at most `threads` -many threads,
+  // including the calling one.
+  // Worker threads are spawned on first use and live as long as the hasher.
+  inline explicit parallelhash_t(const size_t block_len,
+                                 std::span<const uint8_t> cust = {},
+                                 const size_t threads = 1)
+    : blk_buf(block_len)
+    , pool(std::make_unique<sha3_utils::worker_pool_t>(threads))
+  {
+    assert(block_len > 0);
+
+    constexpr size_t rbytes = RATE / 8;
+
+    // bytepad(encode_string(N) || encode_string(S), rate/ 8)
+    absorb_encoded<left_encode>(rbytes);
+    absorb_encoded<left_encode>(FUNCTION_NAME.size() * 8);
+    absorb_cshake(FUNCTION_NAME);
+    absorb_encoded<left_encode>(cust.size() * 8);
+    absorb_cshake(cust);
+
+    if (offset > 0) {
+      constexpr std::array<uint8_t, rbytes> zeros{};
+      absorb_cshake(std::span(zeros).first(rbytes - offset));
+    }
+
+    absorb_encoded<left_encode>(blk_buf.size());
+
+    std::copy(std::begin(state), std::end(state), std::begin(init_state));
+    init_offset = offset;
+  }
+
+  // Given N -many bytes input message, this routine consumes those into
+  // ParallelHash. All complete blocks are hashed right away, while remaining
+  // message bytes are buffered internally, at most a single block.
+  //
+  // Note, this routine can be called arbitrary number of times, each time with
+  // arbitrary bytes of input message, until the state is finalized ( by calling
+  // routine with similar name ). Once finalized, it can't absorb any more
+  // message bytes.
+  inline void absorb(std::span<const uint8_t> msg)
+  {
+    if (finalized) {
+      return;
+    }
+
+    const size_t B = blk_buf.size();
+
+    // Complete partially filled block
+    if (blk_len > 0) {
+      const size_t len = std::min(B - blk_len, msg.size());
+
+      std::copy_n(msg.begin(), len, blk_buf.begin() + blk_len);
+      blk_len += len;
+      msg = msg.subspan(len);
+
+      if (blk_len < B) {
+        return;
+      }
+
+      std::array<uint8_t, CV_LEN> cv{};
+      sponge::oneshot<RATE>(blk_buf, BLOCK_DOM_SEP, cv);
+      absorb_cshake(cv);
+
+      blk_len = 0;
+      blk_cnt++;
+    }
+
+    // Hash all complete blocks
+    const size_t cnt = msg.size() / B;
+    if (cnt > 0) {
+      std::vector<uint8_t> cvs(cnt * CV_LEN);
+
+      sponge::oneshot_many<RATE>(
+        msg.first(cnt * B), B, BLOCK_DOM_SEP, cvs, CV_LEN, *pool);
+      absorb_cshake(cvs);
+
+      blk_cnt += cnt;
+      msg = msg.subspan(cnt * B);
+    }
+
+    std::copy(msg.begin(), msg.end(), blk_buf.begin());
+    blk_len = msg.size();
+  }
+
+  // Same as above, but message is given as a sequence of ( possibly empty )
+  // fragments, which are absorbed as if they were concatenated. As blocks are
+  // already staged in an internal buffer, fragments are absorbed one after
+  // another.
+  inline void absorb(std::span<const std::span<const uint8_t>> frags)
+  {
+    for (const auto frag : frags) {
+      absorb(frag);
+    }
+  }
+
+  // After consuming arbitrary many input bytes, this routine is invoked when
+  // no more input bytes remaining to be consumed. It hashes last, possibly
+  // partial, block and finalizes cSHAKE sponge, encoding requested output
+  // length of `olen` -bytes. When `olen` is 0 ( default ), ParallelHashXOF is
+  // computed, from which arbitrary many bytes can be squeezed, otherwise
+  // exactly `olen` -bytes are supposed to be squeezed.
+  //
+  // Note, once this routine is called, calling absorb() or finalize() again, on
+  // same ParallelHash object, doesn't do anything. After finalization, output
+  // bytes are read by calling squeeze() function, as many times required.
+  inline void finalize(const size_t olen = 0)
+  {
+    if (finalized) {
+      return;
+    }
+
+    if (blk_len > 0) {
+      std::array<uint8_t, CV_LEN> cv{};
+      sponge::oneshot<RATE>(
+        std::span(blk_buf).first(blk_len), BLOCK_DOM_SEP, cv);
+      absorb_cshake(cv);
+
+      blk_len = 0;
+      blk_cnt++;
+    }
+
+    absorb_encoded<right_encode>(blk_cnt);
+    absorb_encoded<right_encode>(olen * 8);
+
+    sponge::finalize<CSHAKE_DOM_SEP, CSHAKE_DOM_SEP_BW, RATE>(state, offset);
+
+    finalized = true;
+    squeezable = RATE / 8;
+  }
+
+  // After sponge state is finalized, output bytes can be squeezed by calling
+  // this function any number of times required.
+  inline void squeeze(std::span<uint8_t> dig)
+  {
+    if (finalized) {
+      sponge::squeeze<RATE>(state, squeezable, dig);
+    }
+  }
+
+  // Reset the internal state of the ParallelHash hasher, now it can again be
+  // used for another absorb->finalize->squeeze cycle, using same block length,
+  // customization string and number of worker threads.
+  inline void reset()
+  {
+    std::copy(std::begin(init_state), std::end(init_state), std::begin(state));
+    offset = init_offset;
+    squeezable = 0;
+    std::fill(blk_buf.begin(), blk_buf.end(), 0);
+    blk_len = 0;
+    blk_cnt = 0;
+    finalized = false;
+  }
+};
+
+// ParallelHash128, offering 128 -bit security, built on SHAKE128 and cSHAKE128
+using parallelhash128_t = parallelhash_t<shake128::CAPACITY>;
+
+// ParallelHash256, offering 256 -bit security, built on SHAKE256 and cSHAKE256
+using parallelhash256_t = parallelhash_t<shake256::CAPACITY>;
+
+}
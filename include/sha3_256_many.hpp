@@ -0,0 +1,27 @@
+#pragma once
+#include "sha3_256.hpp"
+#include "sponge_batched.hpp"
+#include <cassert>
+
+// SHA3-256 hashing of many messages at once, on lanes of batched Keccak
+// permutations. It's kept apart from `sha3_256.hpp`, so that hashing a single
+// message doesn't pull in batched permutation kernels and worker threads.
+namespace sha3_256 {
+
+// Given arbitrary many messages, each of arbitrary, possibly unequal, length,
+// this routine computes SHA3-256 digest of each of them, writing i-th digest
+// at offset `i * DIGEST_LEN` of `mds`, which must be at least `msgs.size() *
+// DIGEST_LEN` -bytes long, as asserted, because digests are written through
+// raw pointers. Messages are hashed together, on lanes of batched Keccak
+// permutation, see `sponge::oneshot_many`.
+inline void
+hash_many(std::span<const std::span<const uint8_t>> msgs,
+          std::span<uint8_t> mds)
+{
+  assert(mds.size() >= msgs.size() * DIGEST_LEN);
+
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot_many<RATE>(msgs, domain_separator, mds, DIGEST_LEN);
+}
+
+}
@@ -49,6 +49,16 @@ public:
     }
   }
 
+  // Same as above, but message is given as a sequence of ( possibly empty )
+  // fragments, which are absorbed as if they were concatenated, staging only
+  // the block straddling fragment boundaries, see `sponge::absorb`.
+  inline constexpr void absorb(std::span<const std::span<const uint8_t>> frags)
+  {
+    if (!finalized) {
+      sponge::absorb<RATE>(state, offset, frags);
+    }
+  }
+
   // Finalizes the sponge after all message bytes are absorbed into it, now it
   // should be ready for squeezing message digest bytes. Once finalized, you
   // can't absorb any message bytes into sponge. After finalization, calling
@@ -85,4 +95,27 @@ public:
   }
 };
 
+// Given N (>=0) -bytes message, this routine computes its SHA3-512 digest, in
+// a single call, without going through `sha3_512_t`. When message fits in a
+// single block, it takes a fast path, which is a single permutation, see
+// `sponge::oneshot`.
+inline constexpr void
+hash(std::span<const uint8_t> msg, std::span<uint8_t, DIGEST_LEN> md)
+{
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot<RATE>(msg, domain_separator, md);
+}
+
+// Same as above, but for message of length known at compile-time, so that
+// block splitting, placement of padding and trip counts of all loops are
+// resolved during compilation, see `sponge::oneshot_fixed`.
+template<size_t mlen>
+inline constexpr void
+hash(std::span<const uint8_t, mlen> msg, std::span<uint8_t, DIGEST_LEN> md)
+  requires(mlen != std::dynamic_extent)
+{
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot_fixed<RATE, mlen, DIGEST_LEN>(msg, domain_separator, md);
+}
+
 }
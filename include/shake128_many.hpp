@@ -0,0 +1,29 @@
+#pragma once
+#include "shake128.hpp"
+#include "sponge_batched.hpp"
+#include <cassert>
+
+// SHAKE128 hashing of many messages at once, on lanes of batched Keccak
+// permutations. It's kept apart from `shake128.hpp`, so that hashing a single
+// message doesn't pull in batched permutation kernels and worker threads.
+namespace shake128 {
+
+// Given arbitrary many messages, each of arbitrary, possibly unequal, length,
+// this routine squeezes `olen` -bytes output of SHAKE128 Xof for each of them,
+// writing i-th output at offset `i * olen` of `outs`, which must be at least
+// `msgs.size() * olen` -bytes long, as asserted, because outputs are written
+// through raw pointers. Trailing bytes of `outs`, if any, are left untouched.
+// Messages are hashed together, on lanes of batched Keccak permutation, see
+// `sponge::oneshot_many`.
+inline void
+hash_many(std::span<const std::span<const uint8_t>> msgs,
+          std::span<uint8_t> outs,
+          const size_t olen)
+{
+  assert(outs.size() >= msgs.size() * olen);
+
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot_many<RATE>(msgs, domain_separator, outs, olen);
+}
+
+}
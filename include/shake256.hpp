@@ -45,6 +45,16 @@ public:
     }
   }
 
+  // Same as above, but message is given as a sequence of ( possibly empty )
+  // fragments, which are absorbed as if they were concatenated, staging only
+  // the block straddling fragment boundaries, see `sponge::absorb`.
+  inline constexpr void absorb(std::span<const std::span<const uint8_t>> frags)
+  {
+    if (!finalized) {
+      sponge::absorb<RATE>(state, offset, frags);
+    }
+  }
+
   // After consuming arbitrary many input bytes, this routine is invoked when
   // no more input bytes remaining to be consumed by keccak[512] state.
   //
@@ -71,6 +81,18 @@ public:
     }
   }
 
+  // After sponge state is finalized, `n` whole rate blocks i.e. `n * RATE/ 8`
+  // -bytes are squeezed into `dig`, which must be at least that long, as
+  // asserted. Output is same as squeezing those many bytes using squeeze(),
+  // while when called at a block boundary, each block is written straight out
+  // of the state.
+  inline constexpr void squeeze_blocks(const size_t n, std::span<uint8_t> dig)
+  {
+    if (finalized) {
+      sponge::squeeze_blocks<RATE>(state, squeezable, n, dig);
+    }
+  }
+
   // Reset the internal state of the Shake256-Xof hasher, now it can again be
   // used for another absorb->finalize->squeeze cycle.
   inline constexpr void reset()
@@ -82,4 +104,28 @@ public:
   }
 };
 
+// Given N (>=0) -bytes message, this routine squeezes arbitrary many ( = M )
+// output bytes of SHAKE256 Xof, in a single call, without going through
+// `shake256_t`. When message fits in a single block, it takes a fast path,
+// which is a single permutation ( as long as M <= RATE/ 8 ), see
+// `sponge::oneshot`.
+inline constexpr void
+hash(std::span<const uint8_t> msg, std::span<uint8_t> out)
+{
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot<RATE>(msg, domain_separator, out);
+}
+
+// Same as above, but for message and output of length known at compile-time,
+// so that block splitting, placement of padding and trip counts of all loops
+// are resolved during compilation, see `sponge::oneshot_fixed`.
+template<size_t mlen, size_t olen>
+inline constexpr void
+hash(std::span<const uint8_t, mlen> msg, std::span<uint8_t, olen> out)
+  requires((mlen != std::dynamic_extent) && (olen != std::dynamic_extent))
+{
+  constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+  sponge::oneshot_fixed<RATE, mlen, olen>(msg, domain_separator, out);
+}
+
 }
@@ -0,0 +1,91 @@
+#pragma once
+#include "shake256.hpp"
+#include "sponge_batched.hpp"
+#include <array>
+
+// 4-way SHAKE256, for expanding several seeds at once. It's kept apart from
+// `shake256.hpp`, so that a single SHAKE256 instance doesn't pull in batched
+// permutation kernels.
+namespace shake256 {
+
+// 4-way SHAKE256 Xof, absorbing four messages of equal length and squeezing
+// four output streams of equal length, in lock-step, keeping all four
+// keccak[512] sponges lane-interleaved, so that they are permuted together,
+// using `keccak::permute_x4`. Output of each stream is same as what
+// `shake256_t` produces for corresponding message.
+struct shake256x4_t
+{
+private:
+  static constexpr size_t WAYS = keccak::X4_WAYS;
+
+  uint64_t state[keccak::LANE_CNT * WAYS]{};
+  size_t offset = 0;
+  alignas(4) bool finalized = false; // all message bytes absorbed ?
+  size_t squeezable = 0;
+
+public:
+  inline shake256x4_t() = default;
+
+  // Given four N -bytes input messages, this routine consumes those into
+  // corresponding keccak[512] sponge states. All four messages must be of
+  // same length, which is asserted.
+  //
+  // Note, this routine can be called arbitrary number of times, until the
+  // sponges are finalized, each time with arbitrary, but equal, number of
+  // bytes of input messages.
+  inline void absorb(std::span<const uint8_t> msg0,
+                     std::span<const uint8_t> msg1,
+                     std::span<const uint8_t> msg2,
+                     std::span<const uint8_t> msg3)
+  {
+    if (!finalized) {
+      const std::array<std::span<const uint8_t>, WAYS> msgs{
+        msg0, msg1, msg2, msg3
+      };
+      sponge::absorb_xN<RATE, WAYS, keccak::permute_x4>(state, offset, msgs);
+    }
+  }
+
+  // After consuming all input bytes, this routine finalizes all four sponges
+  // together, making them ready for squeezing. Calling it again doesn't do
+  // anything.
+  inline void finalize()
+  {
+    if (!finalized) {
+      constexpr uint8_t domain_separator = (1 << DOM_SEP_BW) | DOM_SEP;
+      sponge::finalize_xN<RATE, WAYS, keccak::permute_x4>(
+        state, offset, domain_separator);
+
+      finalized = true;
+      squeezable = RATE / 8;
+    }
+  }
+
+  // After sponges are finalized, arbitrary, but equal, number of output bytes
+  // can be squeezed out of each of them, by calling this function any number
+  // of times required. All four outputs must be of same length, which is
+  // asserted.
+  inline void squeeze(std::span<uint8_t> dig0,
+                      std::span<uint8_t> dig1,
+                      std::span<uint8_t> dig2,
+                      std::span<uint8_t> dig3)
+  {
+    if (finalized) {
+      const std::array<std::span<uint8_t>, WAYS> digs{ dig0, dig1, dig2, dig3 };
+      sponge::squeeze_xN<RATE, WAYS, keccak::permute_x4>(
+        state, squeezable, digs);
+    }
+  }
+
+  // Reset the internal state of the 4-way SHAKE256 Xof hasher, now it can
+  // again be used for another absorb->finalize->squeeze cycle.
+  inline void reset()
+  {
+    std::fill(std::begin(state), std::end(state), 0);
+    offset = 0;
+    finalized = false;
+    squeezable = 0;
+  }
+};
+
+}
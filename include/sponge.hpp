@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <span>
@@ -25,6 +26,16 @@ check_domain_separator(const size_t dom_sep_bit_len)
   return (dom_sep_bit_len == 2) | (dom_sep_bit_len == 4);
 }
 
+// Check to ensure that domain separation byte, which is known only at runtime,
+// ∈ [0x01, 0x7f], as required by TurboSHAKE.
+//
+// See section 2.2 of TurboSHAKE specification https://ia.cr/2023/342
+constexpr bool
+check_domain_separation_byte(const uint8_t domain_separator)
+{
+  return (domain_separator >= 0x01) & (domain_separator <= 0x7f);
+}
+
 // Pad10*1 - generates a padding, while also considering domain separator bits (
 // which are either 2 or 4 -bit wide ), such that when both domain separator
 // bits and 10*1 padding is appended ( in order ) to actual message, total byte
@@ -53,68 +64,201 @@ pad10x1(const size_t offset)
   return res;
 }
 
+// Given a full message block of `rate/ 8` -bytes, this routine XORs it into
+// rate portion of Keccak[c] permutation state. On little-endian targets, when
+// not evaluated in compile-time, lanes are read straight from the ( possibly
+// unaligned ) message, without staging them in any intermediate buffer.
+template<size_t rate>
+static inline constexpr void
+absorb_block(uint64_t state[keccak::LANE_CNT],
+             std::span<const uint8_t, rate / 8> blk)
+{
+  constexpr size_t rwords = rate >> 6; // # -of 64 -bit words
+
+  if constexpr (std::endian::native == std::endian::little) {
+    if (!std::is_constant_evaluated()) {
+      for (size_t j = 0; j < rwords; j++) {
+        uint64_t word;
+        std::memcpy(&word, blk.data() + j * 8, sizeof(word));
+
+        state[j] ^= word;
+      }
+
+      return;
+    }
+  }
+
+  for (size_t j = 0; j < rwords; j++) {
+    state[j] ^= sha3_utils::le_bytes_to_u64(blk.subspan(j * 8, 8));
+  }
+}
+
+// Given at most `rbytes - offset` -bytes, this routine XORs them into rate
+// portion of Keccak[c] permutation state, starting at byte `offset`, touching
+// only the lanes those bytes fall into, so that its cost is proportional to
+// number of bytes, rather than to the rate.
+static inline constexpr void
+absorb_bytes(uint64_t state[keccak::LANE_CNT],
+             const size_t offset,
+             std::span<const uint8_t> bytes)
+{
+  const size_t len = bytes.size();
+  size_t i = 0;
+
+  // Leading bytes, until a lane boundary is reached
+  for (; (i < len) && (((offset + i) & 7ul) != 0); i++) {
+    const size_t idx = offset + i;
+    state[idx >> 3] ^= static_cast<uint64_t>(bytes[i]) << ((idx & 7ul) << 3);
+  }
+
+  // Whole lanes
+  for (; i + 8 <= len; i += 8) {
+    const auto lane = bytes.subspan(i, 8);
+    state[(offset + i) >> 3] ^= sha3_utils::le_bytes_to_u64(lane);
+  }
+
+  // Trailing bytes
+  for (; i < len; i++) {
+    const size_t idx = offset + i;
+    state[idx >> 3] ^= static_cast<uint64_t>(bytes[i]) << ((idx & 7ul) << 3);
+  }
+}
+
+// Given a contiguous run of message blocks, each of `rate/ 8` -bytes, this
+// routine absorbs all of them into Keccak[c] permutation state, applying
+// Keccak-p[1600, nr] permutation after each block.
+//
+// When `keccak::permute` is backed by the lane complementing kernel, blocks are
+// absorbed using `keccak::absorb_blocks_lc`, which keeps the state in registers
+// across all blocks and XORs each block into the state inside θ of the first
+// round. Otherwise each block is XOR-ed into the state and permuted using
+// whichever kernel is selected, see `keccak::permute_is_lc`.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+absorb_blocks(uint64_t state[keccak::LANE_CNT], std::span<const uint8_t> blks)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  if (!std::is_constant_evaluated() && keccak::permute_is_lc<rounds>()) {
+    keccak::absorb_blocks_lc<rate, rounds>(state, blks);
+    return;
+  }
+
+  for (size_t off = 0; off + rbytes <= blks.size(); off += rbytes) {
+    absorb_block<rate>(state, blks.subspan(off).template first<rbytes>());
+    keccak::permute<rounds>(state);
+  }
+}
+
 // Given `mlen` (>=0) -bytes message, this routine consumes it into Keccak[c]
 // permutation state s.t. `offset` ( second parameter ) denotes how many bytes
 // are already consumed into rate portion of the state.
 //
 // - `rate` portion of sponge will have bitwidth of 1600 - c.
 // - `offset` must ∈ [0, `rbytes`).
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
+//
+// Full blocks are absorbed straight from the message, while bytes of partially
+// filled first and last blocks are XORed into only the lanes they fall into.
+// Hence absorbing a few bytes, at a time, costs proportional to their count.
 //
 // This function implementation collects inspiration from
 // https://github.com/itzmeanjan/turboshake/blob/e1a6b950/src/sponge.rs#L4-L56
-template<size_t rate>
+template<size_t rate, size_t rounds = keccak::ROUNDS>
 static inline constexpr void
 absorb(uint64_t state[keccak::LANE_CNT],
        size_t& offset,
        std::span<const uint8_t> msg)
 {
-  constexpr size_t rbytes = rate >> 3;   // # -of bytes
-  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
-
-  std::array<uint8_t, rbytes> blk_bytes{};
-  std::array<uint64_t, rwords> blk_words{};
-
-  auto _blk_bytes = std::span(blk_bytes);
-  auto _blk_words = std::span(blk_words);
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
 
   const size_t mlen = msg.size();
-  const size_t blk_cnt = (offset + mlen) / rbytes;
-
   size_t moff = 0;
 
-  for (size_t i = 0; i < blk_cnt; i++) {
-    const size_t readable = rbytes - offset;
-
-    auto _msg = msg.subspan(moff, readable);
-    auto _blk = _blk_bytes.subspan(offset, readable);
+  // Partially filled first block
+  if (offset > 0) {
+    const size_t len = std::min(rbytes - offset, mlen);
 
-    std::copy(_msg.begin(), _msg.end(), _blk.begin());
-    sha3_utils::le_bytes_to_u64_words<rate>(_blk_bytes, _blk_words);
+    absorb_bytes(state, offset, msg.first(len));
+    offset += len;
+    moff += len;
 
-    for (size_t j = 0; j < rwords; j++) {
-      state[j] ^= _blk_words[j];
+    if (offset < rbytes) {
+      return;
     }
 
-    keccak::permute(state);
-
-    moff += readable;
+    keccak::permute<rounds>(state);
     offset = 0;
   }
 
-  const size_t rm_bytes = mlen - moff;
+  // Full blocks, absorbed straight from the message
+  const size_t blk_cnt = (mlen - moff) / rbytes;
 
-  auto _msg = msg.subspan(moff, rm_bytes);
-  auto _blk = _blk_bytes.subspan(offset, rm_bytes);
+  if (blk_cnt > 0) {
+    absorb_blocks<rate, rounds>(state, msg.subspan(moff, blk_cnt * rbytes));
+    moff += blk_cnt * rbytes;
+  }
 
-  blk_bytes.fill(0x00);
-  std::copy(_msg.begin(), _msg.end(), _blk.begin());
-  sha3_utils::le_bytes_to_u64_words<rate>(_blk_bytes, _blk_words);
+  // Partially filled last block
+  absorb_bytes(state, 0, msg.subspan(moff));
+  offset = mlen - moff;
+}
 
-  for (size_t j = 0; j < rwords; j++) {
-    state[j] ^= _blk_words[j];
+// Same as above, but message is given as a sequence of ( possibly empty )
+// fragments, e.g. as handed over by a network stack, which are absorbed as if
+// they were concatenated. Full blocks, lying within a fragment, are absorbed
+// straight from it, while a block straddling fragment boundaries is staged in
+// a `rbytes` -bytes buffer, so that it's XOR-ed into the state at once, rather
+// than in pieces, one per fragment.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+absorb(uint64_t state[keccak::LANE_CNT],
+       size_t& offset,
+       std::span<const std::span<const uint8_t>> frags)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  std::array<uint8_t, rbytes> blk{};
+  auto _blk = std::span(blk);
+
+  size_t beg = offset; // staged bytes of block start at `beg`
+  size_t end = offset; // and end at `end`
+
+  for (auto frag : frags) {
+    // Complete the block, staged so far
+    if (end > 0) {
+      const size_t len = std::min(rbytes - end, frag.size());
+
+      std::copy_n(frag.begin(), len, _blk.subspan(end).begin());
+      end += len;
+      frag = frag.subspan(len);
+
+      if (end < rbytes) {
+        continue;
+      }
+
+      absorb_bytes(state, beg, _blk.subspan(beg));
+      keccak::permute<rounds>(state);
+
+      beg = 0;
+      end = 0;
+    }
+
+    // Full blocks, absorbed straight from the fragment
+    const size_t blk_cnt = frag.size() / rbytes;
+
+    if (blk_cnt > 0) {
+      absorb_blocks<rate, rounds>(state, frag.first(blk_cnt * rbytes));
+      frag = frag.subspan(blk_cnt * rbytes);
+    }
+
+    // Remaining bytes start staging next block
+    std::copy(frag.begin(), frag.end(), _blk.begin());
+    end = frag.size();
   }
 
-  offset += rm_bytes;
+  absorb_bytes(state, beg, _blk.subspan(beg, end - beg));
+  offset = end;
 }
 
 // Given that N message bytes are already consumed into Keccak[c] permutation
@@ -125,10 +269,14 @@ absorb(uint64_t state[keccak::LANE_CNT],
 //
 // - `rate` portion of sponge will have bitwidth of 1600 - c.
 // - `offset` must ∈ [0, `rbytes`)
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
 //
 // This function implementation collects some motivation from
 // https://github.com/itzmeanjan/turboshake/blob/e1a6b950/src/sponge.rs#L58-L81
-template<uint8_t domain_separator, size_t ds_bits, size_t rate>
+template<uint8_t domain_separator,
+         size_t ds_bits,
+         size_t rate,
+         size_t rounds = keccak::ROUNDS>
 static inline constexpr void
 finalize(uint64_t state[keccak::LANE_CNT], size_t& offset)
   requires(check_domain_separator(ds_bits))
@@ -148,57 +296,282 @@ finalize(uint64_t state[keccak::LANE_CNT], size_t& offset)
     state[j] ^= _padw[j];
   }
 
-  keccak::permute(state);
+  keccak::permute<rounds>(state);
   offset = 0;
 }
 
+// Given that N message bytes are already consumed into Keccak[c] permutation
+// state, this routine finalizes sponge state and makes it ready for squeezing,
+// same as above, but using a domain separation byte, which is known only at
+// runtime. `domain_separator` ∈ [0x01, 0x7f] holds domain separation bits,
+// followed by first bit of 10*1 padding, s.t. it's mixed into the state at
+// `offset`, while last bit of padding is mixed into last byte of rate portion.
+//
+// - `rate` portion of sponge will have bitwidth of 1600 - c.
+// - `offset` must ∈ [0, `rbytes`)
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
+//
+// See section 2.2 of TurboSHAKE specification https://ia.cr/2023/342
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+finalize(uint64_t state[keccak::LANE_CNT],
+         size_t& offset,
+         const uint8_t domain_separator)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  const size_t sh = (offset & 7ul) << 3;
+  state[offset >> 3] ^= static_cast<uint64_t>(domain_separator) << sh;
+  state[(rbytes - 1) >> 3] ^= 0x80ul << 56;
+
+  keccak::permute<rounds>(state);
+  offset = 0;
+}
+
+// Given at most `rbytes - offset` -bytes output buffer, this routine fills it
+// with bytes of rate portion of Keccak[c] permutation state, starting at byte
+// `offset`, reading only the lanes those bytes fall into, so that its cost is
+// proportional to number of bytes, rather than to the rate.
+static inline constexpr void
+squeeze_bytes(const uint64_t state[keccak::LANE_CNT],
+              const size_t offset,
+              std::span<uint8_t> out)
+{
+  const size_t len = out.size();
+  size_t i = 0;
+
+  // Leading bytes, until a lane boundary is reached
+  for (; (i < len) && (((offset + i) & 7ul) != 0); i++) {
+    const size_t idx = offset + i;
+    out[i] = static_cast<uint8_t>(state[idx >> 3] >> ((idx & 7ul) << 3));
+  }
+
+  // Whole lanes
+  for (; i + 8 <= len; i += 8) {
+    sha3_utils::u64_to_le_bytes(state[(offset + i) >> 3], out.subspan(i, 8));
+  }
+
+  // Trailing bytes
+  for (; i < len; i++) {
+    const size_t idx = offset + i;
+    out[i] = static_cast<uint8_t>(state[idx >> 3] >> ((idx & 7ul) << 3));
+  }
+}
+
 // Given that Keccak[c] permutation state is finalized, this routine can be
 // invoked for squeezing `olen` -bytes out of rate portion of the state.
 //
 // - `rate` portion of sponge will have bitwidth of 1600 - c.
 // - `squeezable` denotes how many bytes can be squeezed without permutating the
 // sponge state.
-// - When `squeezable` becomes 0, state needs to be permutated again, after
-// which `rbytes` can again be squeezed from rate portion of the state.
+// - When `squeezable` becomes 0, state is permutated again, only when more
+// output bytes are requested, after which `rbytes` can again be squeezed from
+// rate portion of the state. Hence squeezing exact multiple of `rbytes` doesn't
+// incur a wasted permutation.
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
+//
+// Requested bytes are copied straight out of the state lanes, so that
+// squeezing a few bytes, at a time, costs proportional to their count.
 //
 // This function implementation collects motivation from
 // https://github.com/itzmeanjan/turboshake/blob/e1a6b950/src/sponge.rs#L83-L118
-template<size_t rate>
+template<size_t rate, size_t rounds = keccak::ROUNDS>
 static inline constexpr void
 squeeze(uint64_t state[keccak::LANE_CNT],
         size_t& squeezable,
         std::span<uint8_t> out)
 {
-  constexpr size_t rbytes = rate >> 3;   // # -of bytes
-  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
-
-  std::array<uint8_t, rbytes> blk_bytes{};
-  auto _blk_bytes = std::span(blk_bytes);
-
-  auto swords = std::span{ state, keccak::LANE_CNT };
-  auto _swords = swords.template subspan<0, rwords>();
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
 
   const size_t olen = out.size();
   size_t off = 0;
 
   while (off < olen) {
+    if (squeezable == 0) {
+      keccak::permute<rounds>(state);
+      squeezable = rbytes;
+    }
+
     const size_t read = std::min(squeezable, olen - off);
     const size_t soff = rbytes - squeezable;
 
-    sha3_utils::u64_words_to_le_bytes<rate>(_swords, _blk_bytes);
-
-    auto _blk = _blk_bytes.subspan(soff, read);
-    auto _out = out.subspan(off, read);
-
-    std::copy(_blk.begin(), _blk.end(), _out.begin());
+    squeeze_bytes(state, soff, out.subspan(off, read));
 
     squeezable -= read;
     off += read;
+  }
+}
+
+// Writes whole rate portion of Keccak[c] permutation state into a `rate/ 8`
+// -bytes block. On little-endian targets, when not evaluated in compile-time,
+// lanes are copied straight into the ( possibly unaligned ) destination.
+template<size_t rate>
+static inline constexpr void
+squeeze_block(const uint64_t state[keccak::LANE_CNT],
+              std::span<uint8_t, rate / 8> blk)
+{
+  constexpr size_t rbytes = rate >> 3;   // # -of bytes
+  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
+
+  if constexpr (std::endian::native == std::endian::little) {
+    if (!std::is_constant_evaluated()) {
+      std::memcpy(blk.data(), state, rbytes);
+      return;
+    }
+  }
 
+  for (size_t j = 0; j < rwords; j++) {
+    sha3_utils::u64_to_le_bytes(state[j], blk.subspan(j * 8, 8));
+  }
+}
+
+// Given that Keccak[c] permutation state is finalized, this routine squeezes
+// `n` whole rate blocks, writing them into first `n * rbytes` -bytes of `out`,
+// which must be at least that long, as asserted. Output is same as squeezing those many
+// bytes using `squeeze`, but when no partially squeezed block is pending, each
+// block is written straight out of the permutation state, without any partial
+// block bookkeeping.
+//
+// - `rate` portion of sponge will have bitwidth of 1600 - c.
+// - `squeezable` is same as in `squeeze`.
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+squeeze_blocks(uint64_t state[keccak::LANE_CNT],
+               size_t& squeezable,
+               const size_t n,
+               std::span<uint8_t> out)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  assert(out.size() >= n * rbytes);
+  auto _out = out.first(n * rbytes);
+
+  // Some bytes of current block are already squeezed
+  if ((squeezable != 0) && (squeezable != rbytes)) {
+    squeeze<rate, rounds>(state, squeezable, _out);
+    return;
+  }
+
+  for (size_t i = 0; i < n; i++) {
     if (squeezable == 0) {
-      keccak::permute(state);
-      squeezable = rbytes;
+      keccak::permute<rounds>(state);
+    }
+
+    auto blk = _out.subspan(i * rbytes).template first<rbytes>();
+
+    squeeze_block<rate>(state, blk);
+    squeezable = 0;
+  }
+}
+
+// Given `mlen` (>=0) -bytes message, this routine absorbs it into a fresh
+// Keccak[c] sponge, finalizes it using domain separation byte ( see runtime
+// `finalize` ) and squeezes `olen` -bytes out of it.
+//
+// - `rate` portion of sponge will have bitwidth of 1600 - c.
+// - `rounds` is number of rounds of Keccak-p[1600, nr] permutation.
+//
+// When message, along with padding, fits in a single block, it's XOR-ed
+// straight into the zeroed state, so the whole job is a single permutation,
+// without any block bookkeeping. Similarly, when output fits in a single block,
+// it's read straight out of the state.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+oneshot(std::span<const uint8_t> msg,
+        const uint8_t domain_separator,
+        std::span<uint8_t> out)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  uint64_t state[keccak::LANE_CNT]{};
+  size_t offset = 0;
+
+  if (msg.size() < rbytes) {
+    absorb_bytes(state, 0, msg);
+    offset = msg.size();
+  } else {
+    absorb<rate, rounds>(state, offset, msg);
+  }
+
+  finalize<rate, rounds>(state, offset, domain_separator);
+
+  if (out.size() <= rbytes) {
+    squeeze_bytes(state, 0, out);
+  } else {
+    size_t squeezable = rbytes;
+    squeeze<rate, rounds>(state, squeezable, out);
+  }
+}
+
+// Same as `oneshot`, but for message and output, both of length known at
+// compile-time, so that block splitting, placement of padding and trip counts
+// of all loops are resolved during compilation.
+//
+// - `mlen` (>=0) is byte length of message.
+// - `olen` (>=0) is byte length of output.
+template<size_t rate,
+         size_t mlen,
+         size_t olen,
+         size_t rounds = keccak::ROUNDS>
+static inline constexpr void
+oneshot_fixed(std::span<const uint8_t, mlen> msg,
+              const uint8_t domain_separator,
+              std::span<uint8_t, olen> out)
+{
+  constexpr size_t rbytes = rate >> 3;   // # -of bytes
+  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
+
+  constexpr size_t blk_cnt = mlen / rbytes;
+  constexpr size_t rm_bytes = mlen % rbytes;
+  constexpr size_t rm_words = rm_bytes >> 3;
+
+  uint64_t state[keccak::LANE_CNT]{};
+
+  // Full blocks
+  if constexpr (blk_cnt > 0) {
+    absorb_blocks<rate, rounds>(state, msg.template first<blk_cnt * rbytes>());
+  }
+
+  // Last partially filled block, along with padding
+  const auto last = msg.template last<rm_bytes>();
+
+  for (size_t i = 0; i < rm_words; i++) {
+    state[i] ^= sha3_utils::le_bytes_to_u64(last.subspan(i * 8, 8));
+  }
+
+  uint64_t word = 0;
+  for (size_t i = rm_words * 8; i < rm_bytes; i++) {
+    word |= static_cast<uint64_t>(last[i]) << ((i & 7ul) << 3);
+  }
+
+  word |= static_cast<uint64_t>(domain_separator) << ((rm_bytes & 7ul) << 3);
+
+  state[rm_words] ^= word;
+  state[rwords - 1] ^= 0x80ul << 56;
+
+  keccak::permute<rounds>(state);
+
+  // Full output blocks
+  constexpr size_t oblk_cnt = olen / rbytes;
+  constexpr size_t orm_bytes = olen % rbytes;
+
+  for (size_t b = 0; b < oblk_cnt; b++) {
+    if (b > 0) {
+      keccak::permute<rounds>(state);
     }
+
+    auto blk = out.subspan(b * rbytes).template first<rbytes>();
+    squeeze_block<rate>(state, blk);
+  }
+
+  // Last partially filled output block
+  if constexpr (orm_bytes > 0) {
+    if constexpr (oblk_cnt > 0) {
+      keccak::permute<rounds>(state);
+    }
+
+    squeeze_bytes(state, 0, out.template last<orm_bytes>());
   }
 }
 
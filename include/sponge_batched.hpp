@@ -0,0 +1,528 @@
+#pragma once
+#include "keccak_x2.hpp"
+#include "keccak_x4.hpp"
+#include "keccak_x5.hpp"
+#include "keccak_x8.hpp"
+#include "sponge.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+// Batched Keccak sponges, hashing many equal length messages, independently
+namespace sponge {
+
+// Minimum number of message bytes to be hashed by each worker thread, so that
+// cost of waking up a worker and handing it over a range of messages is
+// amortized.
+constexpr size_t MIN_BYTES_PER_THREAD = 1ul << 16;
+
+// Same as `sponge::absorb`, but for `ways` -many messages of equal length,
+// absorbed into as many lane-interleaved Keccak[c] sponges, which are permuted
+// together, using given batched Keccak-p[1600, nr] permutation. As all of them
+// absorb same number of bytes, they share `offset`. Messages of unequal length
+// are a programmer error, caught by assertion.
+template<size_t rate, size_t ways, void (*permute)(uint64_t*)>
+static inline void
+absorb_xN(uint64_t state[keccak::LANE_CNT * ways],
+          size_t& offset,
+          std::span<const std::span<const uint8_t>, ways> msgs)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  const size_t mlen = msgs[0].size();
+  size_t moff = 0;
+
+  for (size_t j = 1; j < ways; j++) {
+    assert(msgs[j].size() == mlen);
+  }
+
+  while (moff < mlen) {
+    const size_t lidx = offset >> 3;
+
+    if (((offset & 7ul) == 0) && (mlen - moff >= 8)) {
+      for (size_t j = 0; j < ways; j++) {
+        const auto lane = msgs[j].subspan(moff, 8);
+        state[lidx * ways + j] ^= sha3_utils::le_bytes_to_u64(lane);
+      }
+
+      offset += 8;
+      moff += 8;
+    } else {
+      const size_t sh = (offset & 7ul) << 3;
+
+      for (size_t j = 0; j < ways; j++) {
+        state[lidx * ways + j] ^= static_cast<uint64_t>(msgs[j][moff]) << sh;
+      }
+
+      offset += 1;
+      moff += 1;
+    }
+
+    if (offset == rbytes) {
+      permute(state);
+      offset = 0;
+    }
+  }
+}
+
+// Same as runtime `sponge::finalize`, but for `ways` -many lane-interleaved
+// Keccak[c] sponges, all finalized using same domain separation byte.
+template<size_t rate, size_t ways, void (*permute)(uint64_t*)>
+static inline void
+finalize_xN(uint64_t state[keccak::LANE_CNT * ways],
+            size_t& offset,
+            const uint8_t domain_separator)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  const size_t sh = (offset & 7ul) << 3;
+  const uint64_t ds = static_cast<uint64_t>(domain_separator) << sh;
+
+  for (size_t j = 0; j < ways; j++) {
+    state[(offset >> 3) * ways + j] ^= ds;
+    state[((rbytes - 1) >> 3) * ways + j] ^= 0x80ul << 56;
+  }
+
+  permute(state);
+  offset = 0;
+}
+
+// Same as `sponge::squeeze`, but for `ways` -many finalized, lane-interleaved
+// Keccak[c] sponges, squeezing equal length output out of each of them, in
+// lock-step, so that they share `squeezable`. Outputs of unequal length are a
+// programmer error, caught by assertion.
+template<size_t rate, size_t ways, void (*permute)(uint64_t*)>
+static inline void
+squeeze_xN(uint64_t state[keccak::LANE_CNT * ways],
+           size_t& squeezable,
+           std::span<const std::span<uint8_t>, ways> outs)
+{
+  constexpr size_t rbytes = rate >> 3; // # -of bytes
+
+  const size_t olen = outs[0].size();
+  size_t ooff = 0;
+
+  for (size_t j = 1; j < ways; j++) {
+    assert(outs[j].size() == olen);
+  }
+
+  while (ooff < olen) {
+    if (squeezable == 0) {
+      permute(state);
+      squeezable = rbytes;
+    }
+
+    const size_t soff = rbytes - squeezable;
+    const size_t lidx = soff >> 3;
+
+    if (((soff & 7ul) == 0) && (olen - ooff >= 8)) {
+      for (size_t j = 0; j < ways; j++) {
+        const auto lane = outs[j].subspan(ooff, 8);
+        sha3_utils::u64_to_le_bytes(state[lidx * ways + j], lane);
+      }
+
+      squeezable -= 8;
+      ooff += 8;
+    } else {
+      const size_t sh = (soff & 7ul) << 3;
+
+      for (size_t j = 0; j < ways; j++) {
+        outs[j][ooff] = static_cast<uint8_t>(state[lidx * ways + j] >> sh);
+      }
+
+      squeezable -= 1;
+      ooff += 1;
+    }
+  }
+}
+
+// Same as `sponge::oneshot`, but for `ways` -many messages, each of `mlen`
+// -bytes, held one after another in `msgs`, writing `olen` -bytes output of
+// each, one after another, into `outs`. Sponge states are kept
+// lane-interleaved, so that they are permuted together, using given batched
+// Keccak-p[1600, nr] permutation.
+template<size_t rate, size_t rounds, size_t ways, void (*permute)(uint64_t*)>
+static inline void
+oneshot_xN(const uint8_t* const __restrict msgs,
+           const size_t mlen,
+           const uint8_t domain_separator,
+           uint8_t* const __restrict outs,
+           const size_t olen)
+{
+  constexpr size_t rbytes = rate >> 3;   // # -of bytes
+  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
+
+  const size_t full_blk_cnt = mlen / rbytes;
+  const size_t rm_bytes = mlen % rbytes;
+  const size_t rm_words = rm_bytes >> 3;
+
+  uint64_t state[keccak::LANE_CNT * ways]{};
+
+  for (size_t b = 0; b < full_blk_cnt; b++) {
+    for (size_t j = 0; j < ways; j++) {
+      const uint8_t* const blk = msgs + j * mlen + b * rbytes;
+
+      for (size_t i = 0; i < rwords; i++) {
+        const auto lane = std::span<const uint8_t, 8>(blk + i * 8, 8);
+        state[i * ways + j] ^= sha3_utils::le_bytes_to_u64(lane);
+      }
+    }
+
+    permute(state);
+  }
+
+  // Last partially filled block of each message, along with padding
+  for (size_t j = 0; j < ways; j++) {
+    const uint8_t* const blk = msgs + j * mlen + full_blk_cnt * rbytes;
+
+    for (size_t i = 0; i < rm_words; i++) {
+      const auto lane = std::span<const uint8_t, 8>(blk + i * 8, 8);
+      state[i * ways + j] ^= sha3_utils::le_bytes_to_u64(lane);
+    }
+
+    uint64_t word = 0;
+    for (size_t i = rm_words * 8; i < rm_bytes; i++) {
+      word |= static_cast<uint64_t>(blk[i]) << ((i & 7ul) << 3);
+    }
+
+    const size_t sh = (rm_bytes & 7ul) << 3;
+    word |= static_cast<uint64_t>(domain_separator) << sh;
+
+    state[rm_words * ways + j] ^= word;
+    state[(rwords - 1) * ways + j] ^= 0x80ul << 56;
+  }
+
+  permute(state);
+
+  for (size_t off = 0; off < olen;) {
+    const size_t read = std::min(rbytes, olen - off);
+
+    for (size_t j = 0; j < ways; j++) {
+      uint8_t* const out = outs + j * olen + off;
+
+      for (size_t i = 0; i < read / 8; i++) {
+        const auto lane = std::span<uint8_t>(out + i * 8, 8);
+        sha3_utils::u64_to_le_bytes(state[i * ways + j], lane);
+      }
+
+      for (size_t i = read & ~7ul; i < read; i++) {
+        const uint64_t lane = state[(i >> 3) * ways + j];
+        out[i] = static_cast<uint8_t>(lane >> ((i & 7ul) << 3));
+      }
+    }
+
+    off += read;
+    if (off < olen) {
+      permute(state);
+    }
+  }
+}
+
+// Same as `sponge::oneshot`, but for messages of arbitrary, possibly unequal,
+// length, writing `olen` -bytes output of i-th message at offset `i * olen` of
+// `outs`. Each of `ways` -many lanes of lane-interleaved sponge states is fed
+// a message, one block per permutation. As soon as a lane is done squeezing
+// its output, it's retired and refilled with next message waiting, so that
+// lanes don't idle on the longest message of a batch. Once no message is
+// waiting and only one lane is still busy, that lane is finished using the
+// scalar permutation.
+template<size_t rate, size_t rounds, size_t ways, void (*permute)(uint64_t*)>
+static inline void
+oneshot_ragged_xN(std::span<const std::span<const uint8_t>> msgs,
+                  const uint8_t domain_separator,
+                  std::span<uint8_t> outs,
+                  const size_t olen)
+{
+  constexpr size_t rbytes = rate >> 3;   // # -of bytes
+  constexpr size_t rwords = rbytes >> 3; // # -of 64 -bit words
+
+  const size_t cnt = msgs.size();
+  assert(outs.size() >= cnt * olen);
+
+  const size_t oblk_cnt = std::max<size_t>((olen + rbytes - 1) / rbytes, 1);
+
+  uint64_t state[keccak::LANE_CNT * ways]{};
+  size_t idx[ways]{};  // message fed to lane, `cnt` when lane is idle
+  size_t step[ways]{}; // # -of permutations applied on lane's state
+
+  size_t next = 0;
+  size_t busy = 0;
+
+  for (size_t j = 0; j < ways; j++) {
+    idx[j] = (next < cnt) ? next++ : cnt;
+    busy += idx[j] < cnt;
+  }
+
+  while (busy > 1) {
+    // Next block of each absorbing lane, last one along with padding
+    for (size_t j = 0; j < ways; j++) {
+      if (idx[j] == cnt) {
+        continue;
+      }
+
+      const auto msg = msgs[idx[j]];
+      const size_t full_blk_cnt = msg.size() / rbytes;
+
+      if (step[j] < full_blk_cnt) {
+        const uint8_t* const blk = msg.data() + step[j] * rbytes;
+
+        for (size_t i = 0; i < rwords; i++) {
+          const auto lane = std::span<const uint8_t, 8>(blk + i * 8, 8);
+          state[i * ways + j] ^= sha3_utils::le_bytes_to_u64(lane);
+        }
+      } else if (step[j] == full_blk_cnt) {
+        const uint8_t* const blk = msg.data() + full_blk_cnt * rbytes;
+        const size_t rm_bytes = msg.size() % rbytes;
+        const size_t rm_words = rm_bytes >> 3;
+
+        for (size_t i = 0; i < rm_words; i++) {
+          const auto lane = std::span<const uint8_t, 8>(blk + i * 8, 8);
+          state[i * ways + j] ^= sha3_utils::le_bytes_to_u64(lane);
+        }
+
+        uint64_t word = 0;
+        for (size_t i = rm_words * 8; i < rm_bytes; i++) {
+          word |= static_cast<uint64_t>(blk[i]) << ((i & 7ul) << 3);
+        }
+
+        const size_t sh = (rm_bytes & 7ul) << 3;
+        word |= static_cast<uint64_t>(domain_separator) << sh;
+
+        state[rm_words * ways + j] ^= word;
+        state[(rwords - 1) * ways + j] ^= 0x80ul << 56;
+      }
+    }
+
+    permute(state);
+
+    // Next output block of each squeezing lane, retiring finished ones
+    for (size_t j = 0; j < ways; j++) {
+      if (idx[j] == cnt) {
+        continue;
+      }
+
+      const size_t full_blk_cnt = msgs[idx[j]].size() / rbytes;
+      step[j]++;
+
+      if (step[j] <= full_blk_cnt) {
+        continue;
+      }
+
+      const size_t oblk = step[j] - full_blk_cnt - 1;
+      const size_t off = oblk * rbytes;
+      const size_t read = std::min(rbytes, olen - off);
+
+      uint8_t* const out = outs.data() + idx[j] * olen + off;
+
+      for (size_t i = 0; i < read / 8; i++) {
+        const auto lane = std::span<uint8_t>(out + i * 8, 8);
+        sha3_utils::u64_to_le_bytes(state[i * ways + j], lane);
+      }
+
+      for (size_t i = read & ~7ul; i < read; i++) {
+        const uint64_t lane = state[(i >> 3) * ways + j];
+        out[i] = static_cast<uint8_t>(lane >> ((i & 7ul) << 3));
+      }
+
+      if (oblk + 1 == oblk_cnt) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          state[i * ways + j] = 0;
+        }
+
+        idx[j] = (next < cnt) ? next++ : cnt;
+        step[j] = 0;
+        busy -= idx[j] == cnt;
+      }
+    }
+  }
+
+  // Finish whatever is left of the lane still busy, if any
+  for (size_t j = 0; j < ways; j++) {
+    if (idx[j] == cnt) {
+      continue;
+    }
+
+    const auto msg = msgs[idx[j]];
+    const auto out = outs.subspan(idx[j] * olen, olen);
+    const size_t full_blk_cnt = msg.size() / rbytes;
+
+    if (step[j] == 0) {
+      oneshot<rate, rounds>(msg, domain_separator, out);
+      continue;
+    }
+
+    uint64_t st[keccak::LANE_CNT];
+    for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+      st[i] = state[i * ways + j];
+    }
+
+    if (step[j] <= full_blk_cnt) {
+      size_t offset = 0;
+      absorb<rate, rounds>(st, offset, msg.subspan(step[j] * rbytes));
+      finalize<rate, rounds>(st, offset, domain_separator);
+
+      size_t squeezable = rbytes;
+      squeeze<rate, rounds>(st, squeezable, out);
+    } else {
+      const size_t off = (step[j] - full_blk_cnt) * rbytes;
+
+      size_t squeezable = 0;
+      squeeze<rate, rounds>(st, squeezable, out.subspan(off));
+    }
+  }
+}
+
+// Hashes all messages, each of `mlen` (>0) -bytes, held one after another in
+// `msgs`, writing `olen` -bytes output of each, in order, into `outs`, which
+// must be large enough to hold all of them. Both are asserted. Messages
+// are hashed in batches of eight or four, using whichever of
+// `keccak::permute_x{8,4}` is backed by a SIMD kernel, then in batches of two,
+// using `keccak::permute_x2`, which interleaves both states even without SIMD,
+// and the last message, if any, is hashed alone. When one message would be
+// left over by batches of four, five of them are hashed together, using
+// `keccak::permute_x5`.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline void
+oneshot_many(std::span<const uint8_t> msgs,
+             const size_t mlen,
+             const uint8_t domain_separator,
+             std::span<uint8_t> outs,
+             const size_t olen)
+{
+  assert(mlen > 0);
+
+  const size_t cnt = msgs.size() / mlen;
+  assert(outs.size() >= cnt * olen);
+
+  size_t i = 0;
+
+  if (keccak::permute_x8_is_simd<rounds>()) {
+    constexpr size_t ways = keccak::X8_WAYS;
+    for (; i + ways <= cnt; i += ways) {
+      oneshot_xN<rate, rounds, ways, keccak::permute_x8<rounds>>(
+        msgs.data() + i * mlen,
+        mlen,
+        domain_separator,
+        outs.data() + i * olen,
+        olen);
+    }
+  }
+
+  if (keccak::permute_x5_is_simd<rounds>()) {
+    constexpr size_t ways = keccak::X5_WAYS;
+    if ((cnt - i >= ways) && ((cnt - i) % keccak::X4_WAYS == 1)) {
+      oneshot_xN<rate, rounds, ways, keccak::permute_x5<rounds>>(
+        msgs.data() + i * mlen,
+        mlen,
+        domain_separator,
+        outs.data() + i * olen,
+        olen);
+      i += ways;
+    }
+  }
+
+  if (keccak::permute_x4_is_simd<rounds>()) {
+    constexpr size_t ways = keccak::X4_WAYS;
+    for (; i + ways <= cnt; i += ways) {
+      oneshot_xN<rate, rounds, ways, keccak::permute_x4<rounds>>(
+        msgs.data() + i * mlen,
+        mlen,
+        domain_separator,
+        outs.data() + i * olen,
+        olen);
+    }
+  }
+
+  constexpr size_t ways = keccak::X2_WAYS;
+  for (; i + ways <= cnt; i += ways) {
+    oneshot_xN<rate, rounds, ways, keccak::permute_x2<rounds>>(
+      msgs.data() + i * mlen,
+      mlen,
+      domain_separator,
+      outs.data() + i * olen,
+      olen);
+  }
+
+  for (; i < cnt; i++) {
+    oneshot<rate, rounds>(msgs.subspan(i * mlen, mlen),
+                          domain_separator,
+                          outs.subspan(i * olen, olen));
+  }
+}
+
+// Same as above, but spreading messages across threads of `pool`, s.t. each
+// of them hashes a contiguous range of messages and writes their outputs at
+// their own position in `outs`. Hence result doesn't depend on number of
+// threads. Threads are only used when each of them gets to hash at least
+// `MIN_BYTES_PER_THREAD` -bytes.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline void
+oneshot_many(std::span<const uint8_t> msgs,
+             const size_t mlen,
+             const uint8_t domain_separator,
+             std::span<uint8_t> outs,
+             const size_t olen,
+             sha3_utils::worker_pool_t& pool)
+{
+  assert(mlen > 0);
+
+  const size_t cnt = msgs.size() / mlen;
+  assert(outs.size() >= cnt * olen);
+
+  const size_t workers = std::clamp<size_t>(
+    std::min(msgs.size() / MIN_BYTES_PER_THREAD, cnt), 1, pool.size());
+
+  if (workers == 1) {
+    oneshot_many<rate, rounds>(msgs, mlen, domain_separator, outs, olen);
+    return;
+  }
+
+  const size_t per_worker = cnt / workers;
+  const size_t extra = cnt % workers;
+
+  pool.run(workers, [&](const size_t w) {
+    const size_t beg = w * per_worker + std::min(w, extra);
+    const size_t len = per_worker + (w < extra);
+
+    oneshot_many<rate, rounds>(msgs.subspan(beg * mlen, len * mlen),
+                               mlen,
+                               domain_separator,
+                               outs.subspan(beg * olen, len * olen),
+                               olen);
+  });
+}
+
+// Hashes all messages, of arbitrary, possibly unequal, length, writing `olen`
+// -bytes output of i-th message at offset `i * olen` of `outs`. Messages are
+// packed into lanes of whichever of `keccak::permute_x{8,4}` is backed by a
+// SIMD kernel, otherwise into lanes of `keccak::permute_x2`, which interleaves
+// both states even without SIMD, see `oneshot_ragged_xN`.
+template<size_t rate, size_t rounds = keccak::ROUNDS>
+static inline void
+oneshot_many(std::span<const std::span<const uint8_t>> msgs,
+             const uint8_t domain_separator,
+             std::span<uint8_t> outs,
+             const size_t olen)
+{
+  if (keccak::permute_x8_is_simd<rounds>()) {
+    constexpr size_t ways = keccak::X8_WAYS;
+    oneshot_ragged_xN<rate, rounds, ways, keccak::permute_x8<rounds>>(
+      msgs, domain_separator, outs, olen);
+    return;
+  }
+
+  if (keccak::permute_x4_is_simd<rounds>()) {
+    constexpr size_t ways = keccak::X4_WAYS;
+    oneshot_ragged_xN<rate, rounds, ways, keccak::permute_x4<rounds>>(
+      msgs, domain_separator, outs, olen);
+    return;
+  }
+
+  constexpr size_t ways = keccak::X2_WAYS;
+  oneshot_ragged_xN<rate, rounds, ways, keccak::permute_x2<rounds>>(
+    msgs, domain_separator, outs, olen);
+}
+
+}
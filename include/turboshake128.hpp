@@ -0,0 +1,110 @@
+#pragma once
+#include "sponge.hpp"
+#include <cassert>
+#include <cstdlib>
+
+// TurboSHAKE128 Extendable Output Function : Keccak-p[1600, 12] based sponge,
+// with 256 -bit capacity, absorbing M || D, s.t. D is domain separation byte.
+namespace turboshake128 {
+
+// Width of capacity portion of the sponge, in bits.
+constexpr size_t CAPACITY = 256;
+
+// Width of rate portion of the sponge, in bits.
+constexpr size_t RATE = 1600 - CAPACITY;
+
+// Number of rounds of Keccak-p[1600, nr] permutation.
+constexpr size_t ROUNDS = 12;
+
+// Default domain separation byte, used for finalization, when none is given.
+constexpr uint8_t DEFAULT_DOM_SEP = 0x1f;
+
+// TurboSHAKE128 Extendable Output Function (Xof)
+//
+// Note, TurboSHAKE128 is not a FIPS 202 function, it's same sponge as SHAKE128,
+// but using Keccak-p[1600, 12] permutation, which is roughly twice as fast,
+// and a domain separation byte, which can be chosen at runtime.
+//
+// See TurboSHAKE specification https://ia.cr/2023/342
+struct turboshake128_t
+{
+private:
+  uint64_t state[keccak::LANE_CNT]{};
+  size_t offset = 0;
+  alignas(4) bool finalized = false; // all message bytes absorbed ?
+  size_t squeezable = 0;
+
+public:
+  inline constexpr turboshake128_t() = default;
+
+  // Given N -many bytes input message, this routine consumes those into
+  // TurboSHAKE128 sponge state.
+  //
+  // Note, this routine can be called arbitrary number of times, each time with
+  // arbitrary bytes of input message, until the state is finalized ( by calling
+  // routine with similar name ). Once the sponge is finalized, it can't absorb
+  // any more message bytes.
+  inline constexpr void absorb(std::span<const uint8_t> msg)
+  {
+    if (!finalized) {
+      sponge::absorb<RATE, ROUNDS>(state, offset, msg);
+    }
+  }
+
+  // Same as above, but message is given as a sequence of ( possibly empty )
+  // fragments, which are absorbed as if they were concatenated, staging only
+  // the block straddling fragment boundaries, see `sponge::absorb`.
+  inline constexpr void absorb(std::span<const std::span<const uint8_t>> frags)
+  {
+    if (!finalized) {
+      sponge::absorb<RATE, ROUNDS>(state, offset, frags);
+    }
+  }
+
+  // After consuming arbitrary many input bytes, this routine is invoked when
+  // no more input bytes remaining to be consumed by the sponge, using domain
+  // separation byte `dom_sep`, which must ∈ [0x01, 0x7f]. Any other byte is a
+  // programmer error, which aborts the program, irrespective of whether
+  // assertions are compiled in or not.
+  //
+  // Note, once this routine is called, calling absorb() or finalize() again, on
+  // same TurboSHAKE128 object, doesn't do anything. After finalization, one
+  // might intend to read arbitrary many bytes by squeezing sponge, which is
+  // done by calling squeeze() function, as many times required.
+  inline constexpr void finalize(const uint8_t dom_sep = DEFAULT_DOM_SEP)
+  {
+    if (!finalized) {
+      const bool valid = sponge::check_domain_separation_byte(dom_sep);
+      assert(valid);
+      if (!valid) {
+        std::abort();
+      }
+
+      sponge::finalize<RATE, ROUNDS>(state, offset, dom_sep);
+
+      finalized = true;
+      squeezable = RATE / 8;
+    }
+  }
+
+  // After sponge state is finalized, arbitrary many output bytes can be
+  // squeezed by calling this function any number of times required.
+  inline constexpr void squeeze(std::span<uint8_t> dig)
+  {
+    if (finalized) {
+      sponge::squeeze<RATE, ROUNDS>(state, squeezable, dig);
+    }
+  }
+
+  // Reset the internal state of the TurboSHAKE128 Xof hasher, now it can again
+  // be used for another absorb->finalize->squeeze cycle.
+  inline constexpr void reset()
+  {
+    std::fill(std::begin(state), std::end(state), 0);
+    offset = 0;
+    finalized = false;
+    squeezable = 0;
+  }
+};
+
+}
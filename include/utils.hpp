@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <charconv>
 #include <cstddef>
@@ -10,6 +12,12 @@
 #include <sstream>
 #include <type_traits>
 
+// POSIX scatter/gather I/O vectors, see `absorb_iovec`
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define SHA3_UTILS_IOVEC 1
+#endif
+
 // Utility ( or commonly used ) functions for SHA3 implementation
 namespace sha3_utils {
 
@@ -105,6 +113,35 @@ u64_words_to_le_bytes(std::span<const uint64_t, rate / 64> words,
   }
 }
 
+#if defined SHA3_UTILS_IOVEC
+
+// Given a sequence of POSIX `struct iovec` buffers, as filled by `readv(2)` or
+// `recvmsg(2)`, this routine absorbs them into `hasher`, as if they were
+// concatenated, viewing them as byte spans, which are handed over to `absorb`
+// of the hasher, accepting message fragments, in batches of at most 16.
+template<typename hasher_t>
+static inline void
+absorb_iovec(hasher_t& hasher, std::span<const iovec> iov)
+{
+  constexpr size_t batch = 16;
+
+  std::array<std::span<const uint8_t>, batch> frags{};
+  auto _frags = std::span<const std::span<const uint8_t>>(frags);
+
+  for (size_t off = 0; off < iov.size(); off += batch) {
+    const size_t cnt = std::min(batch, iov.size() - off);
+
+    for (size_t i = 0; i < cnt; i++) {
+      const auto ptr = static_cast<const uint8_t*>(iov[off + i].iov_base);
+      frags[i] = std::span(ptr, iov[off + i].iov_len);
+    }
+
+    hasher.absorb(_frags.first(cnt));
+  }
+}
+
+#endif
+
 // Generates N -many random values of type T | N >= 0
 template<typename T>
 static inline void
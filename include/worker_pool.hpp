@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads, used for hashing many messages in parallel
+namespace sha3_utils {
+
+// Pool of at most `threads` -many threads, including the calling one, s.t.
+// tasks of a run are picked by the calling thread and by worker threads, which
+// are kept parked between runs. Workers are spawned lazily, by the first run
+// which needs them, so that a pool, which never runs more than a single task,
+// never spawns any thread.
+//
+// Streaming hashers, such as KangarooTwelve and ParallelHash, own a pool, so
+// that they pay for spawning threads only once, instead of on every absorb
+// call. Note, a pool must not be run from more than one thread at a time.
+struct worker_pool_t
+{
+private:
+  std::vector<std::thread> workers{};
+  size_t thread_cnt = 1; // # -of threads, including the calling one
+
+  std::mutex lock{};
+  std::condition_variable wake{}; // signals workers, a run has started
+  std::condition_variable done{}; // signals caller, all tasks are completed
+
+  std::function<void(size_t)> task{};
+  size_t task_cnt = 0;   // # -of tasks in current run
+  size_t next = 0;       // index of next task to be picked
+  size_t pending = 0;    // # -of tasks of current run, not yet completed
+  size_t generation = 0; // # -of runs started so far
+  bool stop = false;     // workers must exit ?
+
+  // Picks and executes tasks of current run, until none is left. Must be
+  // called with `lock` held, which is released while executing a task.
+  inline void drain(std::unique_lock<std::mutex>& guard)
+  {
+    while (next < task_cnt) {
+      const size_t idx = next++;
+
+      guard.unlock();
+      task(idx);
+      guard.lock();
+
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    }
+  }
+
+  // Body of a worker thread, which keeps taking part in runs, started after
+  // run number `seen`, until the pool is destroyed.
+  inline void work(size_t seen)
+  {
+    std::unique_lock guard(lock);
+
+    while (true) {
+      wake.wait(guard, [&]() { return stop || (generation != seen); });
+      if (stop) {
+        return;
+      }
+
+      seen = generation;
+      drain(guard);
+    }
+  }
+
+public:
+  // Creates a pool of at most `threads` -many threads, including the calling
+  // one, without spawning any worker thread yet.
+  inline explicit worker_pool_t(const size_t threads = 1)
+    : thread_cnt(std::max<size_t>(threads, 1))
+  {
+  }
+
+  worker_pool_t(const worker_pool_t&) = delete;
+  worker_pool_t& operator=(const worker_pool_t&) = delete;
+
+  // Wakes up all parked workers, asking them to exit, and joins them.
+  inline ~worker_pool_t()
+  {
+    {
+      std::lock_guard guard(lock);
+      stop = true;
+    }
+
+    wake.notify_all();
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+  // # -of threads, including the calling one, which can execute tasks of a run.
+  inline size_t size() const { return thread_cnt; }
+
+  // Executes `fn(i)`, for each i ∈ [0, cnt), on the calling thread and on as
+  // many as `min(cnt, size()) - 1` worker threads, returning only after all
+  // tasks are completed. Order of execution of tasks is unspecified.
+  inline void run(const size_t cnt, std::function<void(size_t)> fn)
+  {
+    if (cnt == 0) {
+      return;
+    }
+
+    std::unique_lock guard(lock);
+
+    // Workers spawned now take part in this very run
+    const size_t need = std::min(cnt, thread_cnt) - 1;
+    while (workers.size() < need) {
+      workers.emplace_back([this, seen = generation]() { work(seen); });
+    }
+
+    task = std::move(fn);
+    task_cnt = cnt;
+    next = 0;
+    pending = cnt;
+    generation++;
+
+    wake.notify_all();
+    drain(guard);
+    done.wait(guard, [&]() { return pending == 0; });
+
+    task = nullptr;
+    task_cnt = 0;
+  }
+};
+
+}
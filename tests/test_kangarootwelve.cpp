@@ -0,0 +1,137 @@
+#include "kangarootwelve.hpp"
+#include <algorithm>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Test that absorbing same message bytes using both incremental and one-shot
+// hashing, using different number of worker threads, should yield same output
+// bytes, for KangarooTwelve XOF.
+TEST(Sha3Xof, KangarooTwelveIncrementalAbsorptionAndThreadCount)
+{
+  constexpr size_t C = kangarootwelve::CHUNK_LEN;
+  constexpr size_t mlens[]{ 0,     1,         C - 1,         C,
+                            C + 1, 2 * C + 1, 17 * C + 4095, 40 * C + 3 };
+  constexpr size_t threads[]{ 1, 2, 3, 8 };
+
+  for (const size_t mlen : mlens) {
+    std::vector<uint8_t> msg(mlen);
+    std::vector<uint8_t> cust(13);
+    std::vector<uint8_t> out0(200);
+    std::vector<uint8_t> out1(200);
+
+    auto _msg = std::span(msg);
+
+    sha3_utils::random_data<uint8_t>(msg);
+    sha3_utils::random_data<uint8_t>(cust);
+
+    // Split message into fragments, every fifth one being empty
+    std::vector<std::span<const uint8_t>> frags;
+
+    size_t foff = 0;
+    while (foff < mlen) {
+      const size_t flen = (msg[foff] + 1) * 61;
+      const size_t elen =
+        (frags.size() % 5 == 4) ? 0 : std::min(flen, mlen - foff);
+
+      frags.push_back(_msg.subspan(foff, elen));
+      foff += elen;
+    }
+
+    // Oneshot absorption, single threaded
+    kangarootwelve::kangarootwelve_t hasher;
+
+    hasher.absorb(_msg);
+    hasher.finalize(cust);
+    hasher.squeeze(out0);
+
+    for (const size_t t : threads) {
+      kangarootwelve::kangarootwelve_t mt_hasher(t);
+
+      // Incremental absorption, in pieces of varying size
+      size_t off = 0;
+      while (off < mlen) {
+        const auto elen = std::min<size_t>((msg[off] + 1) * 97, mlen - off);
+
+        mt_hasher.absorb(_msg.subspan(off, elen));
+        off += elen;
+      }
+
+      mt_hasher.finalize(cust);
+      mt_hasher.squeeze(out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", threads = " << t;
+
+      // Oneshot absorption, after resetting
+      mt_hasher.reset();
+      mt_hasher.absorb(_msg);
+      mt_hasher.finalize(cust);
+      mt_hasher.squeeze(out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", threads = " << t;
+
+      // Fragmented absorption, in a single call, after resetting
+      mt_hasher.reset();
+      mt_hasher.absorb(frags);
+      mt_hasher.finalize(cust);
+      mt_hasher.squeeze(out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", threads = " << t;
+    }
+  }
+}
+
+// Ensure that KangarooTwelve Xof implementation is conformant with its
+// specification, by using KAT file generated using an independent Python
+// implementation, which reproduces test vectors of
+// https://ia.cr/2016/770 ( also see RFC 9861 ).
+TEST(Sha3Xof, KangarooTwelveKnownAnswerTests)
+{
+  using namespace std::literals;
+
+  const std::string kat_file = "./kats/kangarootwelve.kat";
+  std::fstream file(kat_file);
+
+  while (true) {
+    std::string len0;
+
+    if (!std::getline(file, len0).eof()) {
+      std::string msg0;
+      std::string cust0;
+      std::string out0;
+
+      std::getline(file, msg0);
+      std::getline(file, cust0);
+      std::getline(file, out0);
+
+      auto msg1 = std::string_view(msg0);
+      auto cust1 = std::string_view(cust0);
+      auto out1 = std::string_view(out0);
+
+      auto msg2 = msg1.substr(msg1.find("="sv) + 2, msg1.size());
+      auto cust2 = cust1.substr(cust1.find("="sv) + 2, cust1.size());
+      auto out2 = out1.substr(out1.find("="sv) + 2, out1.size());
+
+      auto msg = sha3_utils::from_hex(msg2);
+      auto cust = sha3_utils::from_hex(cust2);
+      auto out = sha3_utils::from_hex(out2);
+
+      std::vector<uint8_t> squeezed(out.size());
+
+      kangarootwelve::kangarootwelve_t hasher(4);
+
+      hasher.absorb(msg);
+      hasher.finalize(cust);
+      hasher.squeeze(squeezed);
+
+      EXPECT_EQ(squeezed, out);
+
+      std::string empty_line;
+      std::getline(file, empty_line);
+    } else {
+      break;
+    }
+  }
+
+  file.close();
+}
@@ -0,0 +1,482 @@
+#include "keccak_x2.hpp"
+#include "keccak_x4.hpp"
+#include "keccak_x5.hpp"
+#include "keccak_x8.hpp"
+#include "keccak_xn.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+// Applies Keccak-p[1600, 24] permutation `n` -many times on a statically
+// defined state, during compilation-time, so it's always computed by the
+// scalar permutation, irrespective of which kernel is selected for runtime.
+template<size_t n>
+constexpr std::array<uint64_t, keccak::LANE_CNT>
+eval_permute()
+{
+  std::array<uint64_t, keccak::LANE_CNT> state{};
+  std::iota(state.begin(), state.end(), 0);
+
+  for (size_t i = 0; i < n; i++) {
+    keccak::permute(state.data());
+  }
+
+  return state;
+}
+
+// Same as above, but evaluated during program execution, using given
+// permutation kernel.
+template<size_t n>
+std::array<uint64_t, keccak::LANE_CNT>
+eval_permute(void (*permute)(uint64_t*))
+{
+  std::array<uint64_t, keccak::LANE_CNT> state{};
+  std::iota(state.begin(), state.end(), 0);
+
+  for (size_t i = 0; i < n; i++) {
+    permute(state.data());
+  }
+
+  return state;
+}
+
+// Ensure that all supported kernels of 2-way batched Keccak-p[1600, nr]
+// permutation, including the one interleaving two states on general purpose
+// registers, produce same output as applying scalar permutation on each of two
+// states, separately.
+template<size_t rounds>
+static void
+check_batched_permutation_x2()
+{
+  constexpr size_t ways = keccak::X2_WAYS;
+
+  std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+  std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+  for (const auto& k : keccak::permute_x2_kernels<rounds>()) {
+    if (!k.supported) {
+      continue;
+    }
+
+    for (size_t iter = 0; iter < 16; iter++) {
+      sha3_utils::random_data<uint64_t>(states);
+
+      for (size_t j = 0; j < ways; j++) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+        }
+
+        keccak::permute<rounds>(states.data() + j * keccak::LANE_CNT);
+      }
+
+      k.fn(interleaved.data());
+
+      for (size_t j = 0; j < ways; j++) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          EXPECT_EQ(interleaved[i * ways + j],
+                    states[j * keccak::LANE_CNT + i])
+            << k.name;
+        }
+      }
+    }
+  }
+}
+
+TEST(KeccakPermutation, BatchedPermutationX2)
+{
+  check_batched_permutation_x2<keccak::ROUNDS>();
+  check_batched_permutation_x2<12>();
+  check_batched_permutation_x2<13>();
+}
+
+// Ensure that 4-way batched Keccak-p[1600, 24] permutation produces same
+// output as applying scalar permutation on each of four states, separately.
+TEST(KeccakPermutation, BatchedPermutationX4)
+{
+  constexpr size_t ways = keccak::X4_WAYS;
+
+  std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+  std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+  for (size_t iter = 0; iter < 16; iter++) {
+    sha3_utils::random_data<uint64_t>(states);
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+      }
+
+      keccak::permute(states.data() + j * keccak::LANE_CNT);
+    }
+
+    keccak::permute_x4(interleaved.data());
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        EXPECT_EQ(interleaved[i * ways + j], states[j * keccak::LANE_CNT + i]);
+      }
+    }
+  }
+}
+
+// Ensure that all supported kernels of 5-way batched Keccak-p[1600, nr]
+// permutation, including the one mixing SIMD and scalar lanes, produce same
+// output as applying scalar permutation on each of five states, separately.
+template<size_t rounds>
+static void
+check_batched_permutation_x5()
+{
+  constexpr size_t ways = keccak::X5_WAYS;
+
+  std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+  std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+  for (const auto& k : keccak::permute_x5_kernels<rounds>()) {
+    if (!k.supported) {
+      continue;
+    }
+
+    for (size_t iter = 0; iter < 16; iter++) {
+      sha3_utils::random_data<uint64_t>(states);
+
+      for (size_t j = 0; j < ways; j++) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+        }
+
+        keccak::permute<rounds>(states.data() + j * keccak::LANE_CNT);
+      }
+
+      k.fn(interleaved.data());
+
+      for (size_t j = 0; j < ways; j++) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          EXPECT_EQ(interleaved[i * ways + j],
+                    states[j * keccak::LANE_CNT + i])
+            << k.name;
+        }
+      }
+    }
+  }
+}
+
+TEST(KeccakPermutation, BatchedPermutationX5)
+{
+  check_batched_permutation_x5<keccak::ROUNDS>();
+  check_batched_permutation_x5<13>();
+}
+
+// Ensure that 8-way batched Keccak-p[1600, 24] permutation produces same
+// output as applying scalar permutation on each of eight states, separately.
+TEST(KeccakPermutation, BatchedPermutationX8)
+{
+  constexpr size_t ways = keccak::X8_WAYS;
+
+  std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+  std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+  for (size_t iter = 0; iter < 16; iter++) {
+    sha3_utils::random_data<uint64_t>(states);
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+      }
+
+      keccak::permute(states.data() + j * keccak::LANE_CNT);
+    }
+
+    keccak::permute_x8(interleaved.data());
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        EXPECT_EQ(interleaved[i * ways + j], states[j * keccak::LANE_CNT + i]);
+      }
+    }
+  }
+}
+
+// Checks that N-way batched Keccak-p[1600, nr] permutation, written using
+// generic vector extensions, produces same output as applying scalar
+// permutation on each of the states, separately.
+template<size_t ways, size_t rounds>
+static void
+check_batched_permutation_xN()
+{
+  std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+  std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+  for (size_t iter = 0; iter < 16; iter++) {
+    sha3_utils::random_data<uint64_t>(states);
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+      }
+
+      keccak::permute<rounds>(states.data() + j * keccak::LANE_CNT);
+    }
+
+    keccak::permute_xN<ways, rounds>(interleaved.data());
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        EXPECT_EQ(interleaved[i * ways + j], states[j * keccak::LANE_CNT + i]);
+      }
+    }
+  }
+}
+
+TEST(KeccakPermutation, BatchedPermutationXN)
+{
+  check_batched_permutation_xN<2, keccak::ROUNDS>();
+  check_batched_permutation_xN<4, keccak::ROUNDS>();
+  check_batched_permutation_xN<8, keccak::ROUNDS>();
+  check_batched_permutation_xN<4, 12>();
+}
+
+// Ensure that both round function based Keccak-p[1600, 24] permutations
+// produce same output as the default permutation, on any target.
+TEST(KeccakPermutation, RoundFunctionBasedPermutations)
+{
+  constexpr auto expected = eval_permute<16>();
+
+  EXPECT_EQ(eval_permute<16>(keccak::permute_roundx2), expected);
+  EXPECT_EQ(eval_permute<16>(keccak::permute_roundx4), expected);
+}
+
+// Ensure that lane complementing Keccak-p[1600, 24] permutation produces same
+// output as the default permutation.
+TEST(KeccakPermutation, LaneComplementingPermutation)
+{
+  constexpr auto expected = eval_permute<16>();
+  const auto computed = eval_permute<16>(keccak::permute_lc);
+
+  EXPECT_EQ(computed, expected);
+}
+
+// Ensure that compact Keccak-p[1600, 24] permutation, looping over rounds,
+// produces same output as the default permutation.
+TEST(KeccakPermutation, CompactPermutation)
+{
+  constexpr auto expected = eval_permute<16>();
+  const auto computed = eval_permute<16>(keccak::permute_compact);
+
+  EXPECT_EQ(computed, expected);
+}
+
+#if defined KECCAK_X86_64
+
+// Ensure that single-state AVX2 Keccak-p[1600, 24] permutation produces same
+// output as the scalar permutation.
+TEST(KeccakPermutation, SingleStateAVX2Permutation)
+{
+  if (!keccak::cpu_features().avx2) {
+    GTEST_SKIP() << "CPU doesn't support AVX2";
+  }
+
+  constexpr auto expected = eval_permute<16>();
+  const auto computed = eval_permute<16>(keccak::permute_avx2);
+
+  EXPECT_EQ(computed, expected);
+}
+
+#endif
+
+// Checks that each of the runtime dispatchable Keccak-p[1600, nr] permutation
+// kernels, supported by the CPU, produces same output as the scalar
+// permutation, for single-state and batched permutations.
+template<size_t rounds>
+void
+check_dispatchable_kernels()
+{
+  const auto check = [](auto kernels, const size_t ways) {
+    std::vector<uint64_t> states(keccak::LANE_CNT * ways);
+    std::vector<uint64_t> interleaved(keccak::LANE_CNT * ways);
+
+    sha3_utils::random_data<uint64_t>(states);
+
+    for (size_t j = 0; j < ways; j++) {
+      for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+        interleaved[i * ways + j] = states[j * keccak::LANE_CNT + i];
+      }
+
+      keccak::permute_scalar<rounds>(states.data() + j * keccak::LANE_CNT);
+    }
+
+    for (const auto& k : kernels) {
+      if (!k.supported) {
+        continue;
+      }
+
+      auto computed = interleaved;
+      k.fn(computed.data());
+
+      for (size_t j = 0; j < ways; j++) {
+        for (size_t i = 0; i < keccak::LANE_CNT; i++) {
+          EXPECT_EQ(computed[i * ways + j], states[j * keccak::LANE_CNT + i])
+            << k.name << ", rounds = " << rounds;
+        }
+      }
+    }
+  };
+
+  check(keccak::permute_kernels<rounds>(), 1);
+  check(keccak::permute_x4_kernels<rounds>(), keccak::X4_WAYS);
+  check(keccak::permute_x8_kernels<rounds>(), keccak::X8_WAYS);
+}
+
+// Ensure that each of the runtime dispatchable Keccak-p[1600, 24] permutation
+// kernels, supported by the CPU, produces same output as the scalar
+// permutation.
+TEST(KeccakPermutation, DispatchableKernels)
+{
+  constexpr auto expected = eval_permute<16>();
+
+  for (const auto& k : keccak::permute_kernels()) {
+    if (k.supported) {
+      EXPECT_EQ(eval_permute<16>(k.fn), expected) << k.name;
+    }
+  }
+
+  check_dispatchable_kernels<keccak::ROUNDS>();
+}
+
+// Ensure that Keccak-p[1600, 12] permutation produces expected output, which is
+// computed using an independent implementation, and that all kernels agree on
+// Keccak-p[1600, nr], for numbers of rounds, which aren't multiple of what
+// their round functions apply in a single call.
+TEST(KeccakPermutation, RoundReducedPermutation)
+{
+  constexpr auto computed = []() {
+    std::array<uint64_t, keccak::LANE_CNT> state{};
+    std::iota(state.begin(), state.end(), 0);
+
+    keccak::permute<12>(state.data());
+    return state;
+  }();
+
+  constexpr std::array<uint64_t, keccak::LANE_CNT> expected{
+    0x31ccb6fee8eeccfeul, 0x57bf3dcca8d742e7ul, 0x33c23c8e00d5fd2dul,
+    0x27408b85c213997dul, 0x442b508505b591aeul, 0xe7f3957f8698d9d0ul,
+    0x24e9ce4cb83dbdf3ul, 0xc6ed14e10f4998baul, 0xa445718c4dd30e41ul,
+    0xa618c4ddc4f4c14bul, 0x862dab386c0b9ed0ul, 0x0fdade9dec4f977cul,
+    0x38aa031a06ff1231ul, 0xf4b748a9ffecfc5cul, 0xd0af5893c33a5f19ul,
+    0x4dc1ff1ef5fa9c46ul, 0xb15d80df5456c26bul, 0x3a66709440a0c35bul,
+    0xebbdd410f2e7a223ul, 0x7020a73b189a733dul, 0xa3ea1df2b9a8f601ul,
+    0xd15d52bc81a76225ul, 0xeaac3058e82f6ac1ul, 0x1de0c38ae5544e5eul,
+    0x72fa1a9d2dc565ddul,
+  };
+
+  static_assert(computed == expected,
+                "Keccak-p[1600, 12] must be evaluated during compilation");
+
+  std::array<uint64_t, keccak::LANE_CNT> state{};
+  std::iota(state.begin(), state.end(), 0);
+
+  keccak::permute<12>(state.data());
+  EXPECT_EQ(state, expected);
+
+  check_dispatchable_kernels<1>();
+  check_dispatchable_kernels<2>();
+  check_dispatchable_kernels<3>();
+  check_dispatchable_kernels<12>();
+  check_dispatchable_kernels<13>();
+  check_dispatchable_kernels<23>();
+}
+
+// Ensure that kernel named by environment variable is selected, only when it's
+// supported, otherwise the most preferred supported kernel is selected.
+TEST(KeccakPermutation, KernelSelectionByEnvironment)
+{
+  constexpr auto env = "KECCAK_TEST_KERNEL";
+  const auto kernels = keccak::permute_kernels();
+
+  const auto best = std::find_if(kernels.begin(),
+                                 kernels.end(),
+                                 [](const auto& k) { return k.supported; });
+
+  unsetenv(env);
+  EXPECT_EQ(keccak::select_kernel(kernels, env).name, best->name);
+
+  setenv(env, "roundx4", 1);
+  EXPECT_EQ(keccak::select_kernel(kernels, env).name, "roundx4");
+
+  setenv(env, "lc", 1);
+  EXPECT_EQ(keccak::select_kernel(kernels, env).name, "lc");
+
+  setenv(env, "no-such-kernel", 1);
+  EXPECT_EQ(keccak::select_kernel(kernels, env).name, best->name);
+
+  unsetenv(env);
+}
+
+// Ensure that predicates, used for picking a permutation on hot paths, agree
+// with names of kernels backing `keccak::permute{,_x2,_x4,_x5,_x8}`.
+TEST(KeccakPermutation, KernelPredicates)
+{
+  EXPECT_EQ(keccak::permute_is_lc(), keccak::permute_kernel_name() == "lc");
+
+  EXPECT_EQ(keccak::permute_x2_is_simd(),
+            keccak::permute_x2_kernel_name() != "scalar");
+  EXPECT_EQ(keccak::permute_x4_is_simd(),
+            keccak::permute_x4_kernel_name() != "scalar");
+  EXPECT_EQ(keccak::permute_x5_is_simd(),
+            keccak::permute_x5_kernel_name() != "scalar");
+  EXPECT_EQ(keccak::permute_x8_is_simd(),
+            keccak::permute_x8_kernel_name() != "scalar");
+}
+
+// Checks that absorbing a run of message blocks, using fused absorb kernel,
+// produces same state as XOR-ing each block into state and applying scalar
+// Keccak-p[1600, nr] permutation, for Keccak[c] sponge of given rate.
+template<size_t rate, size_t rounds>
+void
+check_absorb_blocks_lc()
+{
+  constexpr size_t rbytes = rate / 8;
+
+  for (size_t blk_cnt = 0; blk_cnt < 5; blk_cnt++) {
+    std::vector<uint8_t> blks(blk_cnt * rbytes);
+    std::array<uint64_t, keccak::LANE_CNT> expected{};
+
+    sha3_utils::random_data<uint8_t>(blks);
+    sha3_utils::random_data<uint64_t>(expected);
+
+    auto computed = expected;
+
+    for (size_t b = 0; b < blk_cnt; b++) {
+      for (size_t i = 0; i < rbytes; i++) {
+        const size_t sh = (i & 7ul) << 3;
+        expected[i >> 3] ^= static_cast<uint64_t>(blks[b * rbytes + i]) << sh;
+      }
+
+      keccak::permute_scalar<rounds>(expected.data());
+    }
+
+    keccak::absorb_blocks_lc<rate, rounds>(computed.data(), blks);
+
+    EXPECT_EQ(computed, expected) << "rate = " << rate << ", rounds = "
+                                  << rounds << ", blocks = " << blk_cnt;
+  }
+}
+
+// Ensure that fused absorb kernel produces same state as absorbing blocks one
+// by one, for rates of all SHA3 hash and extendable output functions, with both
+// odd and even number of rounds.
+TEST(KeccakPermutation, AbsorbBlocksLaneComplementing)
+{
+  check_absorb_blocks_lc<1344, keccak::ROUNDS>();
+  check_absorb_blocks_lc<1152, keccak::ROUNDS>();
+  check_absorb_blocks_lc<1088, keccak::ROUNDS>();
+  check_absorb_blocks_lc<832, keccak::ROUNDS>();
+  check_absorb_blocks_lc<576, keccak::ROUNDS>();
+
+  check_absorb_blocks_lc<1344, 12>();
+  check_absorb_blocks_lc<1088, 12>();
+  check_absorb_blocks_lc<1344, 1>();
+  check_absorb_blocks_lc<576, 23>();
+}
@@ -0,0 +1,202 @@
+#include "parallelhash.hpp"
+#include <algorithm>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Test that absorbing same message bytes using both incremental and one-shot
+// hashing, using different number of worker threads, should yield same output
+// bytes, for ParallelHash{128, 256}.
+template<typename parallelhash_t>
+static void
+test_parallelhash_incremental_absorption_and_thread_count()
+{
+  constexpr size_t block_lens[]{ 1, 168, 8192 };
+  constexpr size_t threads[]{ 1, 2, 3, 8 };
+
+  for (const size_t B : block_lens) {
+    const size_t mlens[]{ 0, 1, B - 1, B, B + 1, 17 * B + 3, 40 * B + B / 2 };
+
+    for (const size_t mlen : mlens) {
+      std::vector<uint8_t> msg(mlen);
+      std::vector<uint8_t> cust(13);
+      std::vector<uint8_t> out0(200);
+      std::vector<uint8_t> out1(200);
+
+      auto _msg = std::span(msg);
+
+      sha3_utils::random_data<uint8_t>(msg);
+      sha3_utils::random_data<uint8_t>(cust);
+
+      // Split message into fragments, every fifth one being empty
+      std::vector<std::span<const uint8_t>> frags;
+
+      size_t foff = 0;
+      while (foff < mlen) {
+        const size_t flen = (msg[foff] + 1) * 61;
+        const size_t elen =
+          (frags.size() % 5 == 4) ? 0 : std::min(flen, mlen - foff);
+
+        frags.push_back(_msg.subspan(foff, elen));
+        foff += elen;
+      }
+
+      // Oneshot absorption, single threaded
+      parallelhash_t hasher(B, cust);
+
+      hasher.absorb(_msg);
+      hasher.finalize(out0.size());
+      hasher.squeeze(out0);
+
+      for (const size_t t : threads) {
+        parallelhash_t mt_hasher(B, cust, t);
+
+        // Incremental absorption, in pieces of varying size
+        size_t off = 0;
+        while (off < mlen) {
+          const auto elen = std::min<size_t>((msg[off] + 1) * 97, mlen - off);
+
+          mt_hasher.absorb(_msg.subspan(off, elen));
+          off += elen;
+        }
+
+        mt_hasher.finalize(out1.size());
+        mt_hasher.squeeze(out1);
+
+        EXPECT_EQ(out0, out1) << "B = " << B << ", mlen = " << mlen
+                              << ", threads = " << t;
+
+        // Oneshot absorption, after resetting
+        mt_hasher.reset();
+        mt_hasher.absorb(_msg);
+        mt_hasher.finalize(out1.size());
+        mt_hasher.squeeze(out1);
+
+        EXPECT_EQ(out0, out1) << "B = " << B << ", mlen = " << mlen
+                              << ", threads = " << t;
+
+        // Fragmented absorption, in a single call, after resetting
+        mt_hasher.reset();
+        mt_hasher.absorb(frags);
+        mt_hasher.finalize(out1.size());
+        mt_hasher.squeeze(out1);
+
+        EXPECT_EQ(out0, out1) << "B = " << B << ", mlen = " << mlen
+                              << ", threads = " << t;
+      }
+    }
+  }
+}
+
+TEST(Sha3Xof, ParallelHash128IncrementalAbsorptionAndThreadCount)
+{
+  test_parallelhash_incremental_absorption_and_thread_count<
+    parallelhash::parallelhash128_t>();
+}
+
+TEST(Sha3Xof, ParallelHash256IncrementalAbsorptionAndThreadCount)
+{
+  test_parallelhash_incremental_absorption_and_thread_count<
+    parallelhash::parallelhash256_t>();
+}
+
+// Ensure that creating ParallelHash{128, 256} with block length B = 0, which is
+// not allowed by SP 800-185, fails loudly, instead of hashing with some other
+// block length. Assertions are compiled out when `NDEBUG` is defined.
+TEST(Sha3Xof, ParallelHashZeroBlockLengthDeathTest)
+{
+#if !defined NDEBUG
+  EXPECT_DEATH(parallelhash::parallelhash128_t{ 0 }, "");
+  EXPECT_DEATH(parallelhash::parallelhash256_t{ 0 }, "");
+#else
+  GTEST_SKIP() << "assertions are disabled";
+#endif
+}
+
+// Ensure that ParallelHash{128, 256} and ParallelHashXOF{128, 256}
+// implementations are conformant with SP 800-185, by using KAT files generated
+// using an independent Python implementation, which reproduces sample values
+// published by NIST.
+template<typename parallelhash_t>
+static void
+test_parallelhash_kat(const std::string kat_file)
+{
+  using namespace std::literals;
+
+  std::fstream file(kat_file);
+
+  while (true) {
+    std::string len0;
+
+    if (!std::getline(file, len0).eof()) {
+      std::string msg0;
+      std::string blen0;
+      std::string cust0;
+      std::string dig0;
+      std::string xof0;
+
+      std::getline(file, msg0);
+      std::getline(file, blen0);
+      std::getline(file, cust0);
+      std::getline(file, dig0);
+      std::getline(file, xof0);
+
+      auto msg1 = std::string_view(msg0);
+      auto blen1 = std::string_view(blen0);
+      auto cust1 = std::string_view(cust0);
+      auto dig1 = std::string_view(dig0);
+      auto xof1 = std::string_view(xof0);
+
+      auto msg2 = msg1.substr(msg1.find("="sv) + 2, msg1.size());
+      auto blen2 = blen1.substr(blen1.find("="sv) + 2, blen1.size());
+      auto cust2 = cust1.substr(cust1.find("="sv) + 2, cust1.size());
+      auto dig2 = dig1.substr(dig1.find("="sv) + 2, dig1.size());
+      auto xof2 = xof1.substr(xof1.find("="sv) + 2, xof1.size());
+
+      auto msg = sha3_utils::from_hex(msg2);
+      auto blen = std::stoul(std::string(blen2));
+      auto cust = sha3_utils::from_hex(cust2);
+      auto dig = sha3_utils::from_hex(dig2);
+      auto xof = sha3_utils::from_hex(xof2);
+
+      std::vector<uint8_t> squeezed(dig.size());
+
+      parallelhash_t hasher(blen, cust, 4);
+
+      hasher.absorb(msg);
+      hasher.finalize(squeezed.size());
+      hasher.squeeze(squeezed);
+
+      EXPECT_EQ(squeezed, dig);
+
+      squeezed.resize(xof.size());
+
+      hasher.reset();
+      hasher.absorb(msg);
+      hasher.finalize();
+      hasher.squeeze(squeezed);
+
+      EXPECT_EQ(squeezed, xof);
+
+      std::string empty_line;
+      std::getline(file, empty_line);
+    } else {
+      break;
+    }
+  }
+
+  file.close();
+}
+
+TEST(Sha3Xof, ParallelHash128KnownAnswerTests)
+{
+  test_parallelhash_kat<parallelhash::parallelhash128_t>(
+    "./kats/parallelhash128.kat");
+}
+
+TEST(Sha3Xof, ParallelHash256KnownAnswerTests)
+{
+  test_parallelhash_kat<parallelhash::parallelhash256_t>(
+    "./kats/parallelhash256.kat");
+}
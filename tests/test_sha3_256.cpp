@@ -1,4 +1,5 @@
 #include "sha3_256.hpp"
+#include "sha3_256_many.hpp"
 #include "test_conf.hpp"
 #include <algorithm>
 #include <fstream>
@@ -82,6 +83,220 @@ TEST(Sha3Hashing, Sha3_256IncrementalAbsorption)
   }
 }
 
+// Ensure that absorbing message, split into fragments of varying length (
+// including empty ones ), in a single call, either directly or through POSIX
+// I/O vectors, after some bytes are already absorbed, yields same digest as
+// absorbing it as a whole.
+TEST(Sha3Hashing, Sha3_256FragmentedAbsorption)
+{
+  constexpr size_t pre_lens[]{ 0, 1, 13, sha3_256::RATE / 8 - 1 };
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen += 3) {
+    for (const size_t pre_len : pre_lens) {
+      std::vector<uint8_t> pre(pre_len);
+      std::vector<uint8_t> msg(mlen);
+      std::vector<uint8_t> out0(sha3_256::DIGEST_LEN);
+      std::vector<uint8_t> out1(sha3_256::DIGEST_LEN);
+
+      auto _msg = std::span(msg);
+      auto _out0 = std::span<uint8_t, sha3_256::DIGEST_LEN>(out0);
+      auto _out1 = std::span<uint8_t, sha3_256::DIGEST_LEN>(out1);
+
+      sha3_utils::random_data<uint8_t>(pre);
+      sha3_utils::random_data<uint8_t>(msg);
+
+      // Split message into fragments, every fifth one being empty
+      std::vector<std::span<const uint8_t>> frags;
+
+      size_t off = 0;
+      while (off < mlen) {
+        const size_t elen = (frags.size() % 5 == 4)
+                              ? 0
+                              : std::min<size_t>(msg[off] + 1, mlen - off);
+
+        frags.push_back(_msg.subspan(off, elen));
+        off += elen;
+      }
+
+      sha3_256::sha3_256_t hasher;
+
+      hasher.absorb(pre);
+      hasher.absorb(_msg);
+      hasher.finalize();
+      hasher.digest(_out0);
+
+      hasher.reset();
+      hasher.absorb(pre);
+      hasher.absorb(frags);
+      hasher.finalize();
+      hasher.digest(_out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", pre = " << pre_len;
+
+#if defined SHA3_UTILS_IOVEC
+      std::vector<iovec> iov(frags.size());
+      for (size_t i = 0; i < frags.size(); i++) {
+        iov[i].iov_base = const_cast<uint8_t*>(frags[i].data());
+        iov[i].iov_len = frags[i].size();
+      }
+
+      std::fill(out1.begin(), out1.end(), 0);
+
+      hasher.reset();
+      hasher.absorb(pre);
+      sha3_utils::absorb_iovec(hasher, iov);
+      hasher.finalize();
+      hasher.digest(_out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", pre = " << pre_len;
+#endif
+    }
+  }
+}
+
+// Ensure that one-shot SHA3-256 hashing, both during compilation-time and
+// program execution, yields same digest as hashing using `sha3_256_t`, for
+// messages of length, both shorter and longer than a single block.
+TEST(Sha3Hashing, Sha3_256OneshotHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, sha3_256::DIGEST_LEN * 2> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, sha3_256::DIGEST_LEN> md{};
+    sha3_256::hash(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_sha3_256(),
+                "Must be able to compute SHA3-256 digest during "
+                "compile-time !");
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen++) {
+    std::vector<uint8_t> msg(mlen);
+    std::vector<uint8_t> out0(sha3_256::DIGEST_LEN);
+    std::vector<uint8_t> out1(sha3_256::DIGEST_LEN);
+
+    auto _out0 = std::span<uint8_t, sha3_256::DIGEST_LEN>(out0);
+    auto _out1 = std::span<uint8_t, sha3_256::DIGEST_LEN>(out1);
+
+    sha3_utils::random_data<uint8_t>(msg);
+
+    sha3_256::sha3_256_t hasher;
+
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.digest(_out0);
+
+    sha3_256::hash(msg, _out1);
+
+    EXPECT_EQ(out0, out1) << "mlen = " << mlen;
+  }
+}
+
+// Checks that SHA3-256 digest of `mlen` -bytes message, computed using one-shot
+// hashing, specialized for given message length, is same as the one computed
+// using one-shot hashing, which works with messages of any length.
+template<size_t... mlens>
+static void
+check_sha3_256_fixed_length_hashing()
+{
+  const auto check = []<size_t mlen>() {
+    std::array<uint8_t, mlen> msg{};
+    std::array<uint8_t, sha3_256::DIGEST_LEN> md0{};
+    std::array<uint8_t, sha3_256::DIGEST_LEN> md1{};
+
+    sha3_utils::random_data<uint8_t>(msg);
+
+    sha3_256::hash(std::span<const uint8_t>(msg), md0);
+    sha3_256::hash<mlen>(msg, md1);
+
+    EXPECT_EQ(md0, md1) << "mlen = " << mlen;
+  };
+
+  (check.template operator()<mlens>(), ...);
+}
+
+// Ensure that one-shot SHA3-256 hashing, specialized for message length known
+// at compile-time, both during compilation-time and program execution, yields
+// same digest as one-shot hashing of message with length known at runtime.
+TEST(Sha3Hashing, Sha3_256FixedLengthHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, sha3_256::DIGEST_LEN * 2> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, sha3_256::DIGEST_LEN> md{};
+    sha3_256::hash<data.size()>(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_sha3_256(),
+                "Must be able to compute SHA3-256 digest during "
+                "compile-time !");
+
+  constexpr size_t rbytes = sha3_256::RATE / 8;
+
+  check_sha3_256_fixed_length_hashing<0, 1, 7, 8, 9, 32, 33, 64, 1184>();
+  check_sha3_256_fixed_length_hashing<rbytes - 9, rbytes - 8, rbytes - 1>();
+  check_sha3_256_fixed_length_hashing<rbytes, rbytes + 1, rbytes + 8>();
+  check_sha3_256_fixed_length_hashing<2 * rbytes, 2 * rbytes + 3>();
+}
+
+// Ensure that SHA3-256 digests of many messages, of unequal length, computed
+// together using batched hashing, are same as computing them one after
+// another.
+TEST(Sha3Hashing, Sha3_256HashMany)
+{
+  constexpr size_t counts[]{ 0, 1, 2, 3, 7, 8, 9, 17, 64 };
+
+  for (const size_t cnt : counts) {
+    std::vector<uint8_t> mlens(cnt);
+    sha3_utils::random_data<uint8_t>(mlens);
+
+    std::vector<std::vector<uint8_t>> msgs(cnt);
+    std::vector<std::span<const uint8_t>> _msgs(cnt);
+
+    for (size_t i = 0; i < cnt; i++) {
+      msgs[i].resize(mlens[i] * 3);
+      sha3_utils::random_data<uint8_t>(msgs[i]);
+      _msgs[i] = msgs[i];
+    }
+
+    std::vector<uint8_t> mds0(cnt * sha3_256::DIGEST_LEN);
+    std::vector<uint8_t> mds1(cnt * sha3_256::DIGEST_LEN);
+
+    auto _mds0 = std::span(mds0);
+
+    for (size_t i = 0; i < cnt; i++) {
+      auto md = _mds0.subspan(i * sha3_256::DIGEST_LEN, sha3_256::DIGEST_LEN);
+      sha3_256::hash(msgs[i], md.first<sha3_256::DIGEST_LEN>());
+    }
+
+    sha3_256::hash_many(_msgs, mds1);
+
+    EXPECT_EQ(mds0, mds1) << "cnt = " << cnt;
+  }
+}
+
+// Ensure that batched SHA3-256 hashing refuses a digest buffer too short to
+// hold digests of all messages, instead of writing past its end. Assertions
+// are compiled out when `NDEBUG` is defined.
+TEST(Sha3Hashing, Sha3_256HashManyShortBufferDeathTest)
+{
+#if !defined NDEBUG
+  std::array<uint8_t, 16> msg{};
+  std::vector<std::span<const uint8_t>> msgs(3, msg);
+  std::vector<uint8_t> mds(3 * sha3_256::DIGEST_LEN - 1);
+
+  EXPECT_DEATH(sha3_256::hash_many(msgs, mds), "");
+#else
+  GTEST_SKIP() << "assertions are disabled";
+#endif
+}
+
 // Ensure that SHA3-256 implementation is conformant with FIPS 202 standard, by
 // using KAT file generated following
 // https://gist.github.com/itzmeanjan/448f97f9c49d781a5eb3ddd6ea6e7364.
@@ -122,6 +337,11 @@ TEST(Sha3Hashing, Sha3_256KnownAnswerTests)
 
       EXPECT_EQ(digest, md);
 
+      std::fill(digest.begin(), digest.end(), 0);
+      sha3_256::hash(msg, _digest);
+
+      EXPECT_EQ(digest, md);
+
       std::string empty_line;
       std::getline(file, empty_line);
     } else {
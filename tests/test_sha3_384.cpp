@@ -1,4 +1,5 @@
 #include "sha3_384.hpp"
+#include "sha3_384_many.hpp"
 #include "test_conf.hpp"
 #include <algorithm>
 #include <fstream>
@@ -44,18 +45,20 @@ TEST(Sha3Hashing, CompileTimeEvalSha3_384)
     "Must be able to compute Sha3-384 hash during compile-time !");
 }
 
-// Test that absorbing same input message bytes using both incremental and
-// one-shot hashing, should yield same output bytes, for SHA3-384 hasher.
+// Test that absorbing same input message bytes using incremental, fragmented
+// and one-shot hashing, should yield same output bytes, for SHA3-384 hasher.
 TEST(Sha3Hashing, Sha3_384IncrementalAbsorption)
 {
   for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen++) {
     std::vector<uint8_t> msg(mlen);
     std::vector<uint8_t> out0(sha3_384::DIGEST_LEN);
     std::vector<uint8_t> out1(sha3_384::DIGEST_LEN);
+    std::vector<uint8_t> out2(sha3_384::DIGEST_LEN);
 
     auto _msg = std::span(msg);
     auto _out0 = std::span<uint8_t, sha3_384::DIGEST_LEN>(out0);
     auto _out1 = std::span<uint8_t, sha3_384::DIGEST_LEN>(out1);
+    auto _out2 = std::span<uint8_t, sha3_384::DIGEST_LEN>(out2);
 
     sha3_utils::random_data(_msg);
 
@@ -82,6 +85,153 @@ TEST(Sha3Hashing, Sha3_384IncrementalAbsorption)
     hasher.digest(_out1);
 
     EXPECT_EQ(out0, out1);
+
+    // Fragmented absorption, every fifth fragment being empty
+    std::vector<std::span<const uint8_t>> frags;
+
+    off = 0;
+    while (off < mlen) {
+      const size_t elen = (frags.size() % 5 == 4)
+                            ? 0
+                            : std::min<size_t>(msg[off] + 1, mlen - off);
+
+      frags.push_back(_msg.subspan(off, elen));
+      off += elen;
+    }
+
+    hasher.reset();
+    hasher.absorb(frags);
+    hasher.finalize();
+    hasher.digest(_out2);
+
+    EXPECT_EQ(out0, out2);
+  }
+}
+
+// Ensure that one-shot SHA3-384 hashing, both during compilation-time and
+// program execution, yields same digest as hashing using `sha3_384_t`, for
+// messages of length, both shorter and longer than a single block.
+TEST(Sha3Hashing, Sha3_384OneshotHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, sha3_384::DIGEST_LEN * 2> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, sha3_384::DIGEST_LEN> md{};
+    sha3_384::hash(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_sha3_384(),
+                "Must be able to compute SHA3-384 digest during "
+                "compile-time !");
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen++) {
+    std::vector<uint8_t> msg(mlen);
+    std::vector<uint8_t> out0(sha3_384::DIGEST_LEN);
+    std::vector<uint8_t> out1(sha3_384::DIGEST_LEN);
+
+    auto _out0 = std::span<uint8_t, sha3_384::DIGEST_LEN>(out0);
+    auto _out1 = std::span<uint8_t, sha3_384::DIGEST_LEN>(out1);
+
+    sha3_utils::random_data<uint8_t>(msg);
+
+    sha3_384::sha3_384_t hasher;
+
+    hasher.absorb(msg);
+    hasher.finalize();
+    hasher.digest(_out0);
+
+    sha3_384::hash(msg, _out1);
+
+    EXPECT_EQ(out0, out1) << "mlen = " << mlen;
+  }
+}
+
+// Checks that SHA3-384 digest of `mlen` -bytes message, computed using one-shot
+// hashing, specialized for given message length, is same as the one computed
+// using one-shot hashing, which works with messages of any length.
+template<size_t... mlens>
+static void
+check_sha3_384_fixed_length_hashing()
+{
+  const auto check = []<size_t mlen>() {
+    std::array<uint8_t, mlen> msg{};
+    std::array<uint8_t, sha3_384::DIGEST_LEN> md0{};
+    std::array<uint8_t, sha3_384::DIGEST_LEN> md1{};
+
+    sha3_utils::random_data<uint8_t>(msg);
+
+    sha3_384::hash(std::span<const uint8_t>(msg), md0);
+    sha3_384::hash<mlen>(msg, md1);
+
+    EXPECT_EQ(md0, md1) << "mlen = " << mlen;
+  };
+
+  (check.template operator()<mlens>(), ...);
+}
+
+// Ensure that one-shot SHA3-384 hashing, specialized for message length known
+// at compile-time, both during compilation-time and program execution, yields
+// same digest as one-shot hashing of message with length known at runtime.
+TEST(Sha3Hashing, Sha3_384FixedLengthHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, sha3_384::DIGEST_LEN * 2> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, sha3_384::DIGEST_LEN> md{};
+    sha3_384::hash<data.size()>(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_sha3_384(),
+                "Must be able to compute SHA3-384 digest during "
+                "compile-time !");
+
+  constexpr size_t rbytes = sha3_384::RATE / 8;
+
+  check_sha3_384_fixed_length_hashing<0, 1, 7, 8, 9, 32, 33, 64, 1184>();
+  check_sha3_384_fixed_length_hashing<rbytes - 9, rbytes - 8, rbytes - 1>();
+  check_sha3_384_fixed_length_hashing<rbytes, rbytes + 1, rbytes + 8>();
+  check_sha3_384_fixed_length_hashing<2 * rbytes, 2 * rbytes + 3>();
+}
+
+// Ensure that SHA3-384 digests of many messages, of unequal length, computed
+// together using batched hashing, are same as computing them one after
+// another.
+TEST(Sha3Hashing, Sha3_384HashMany)
+{
+  constexpr size_t counts[]{ 0, 1, 2, 3, 7, 8, 9, 17, 64 };
+
+  for (const size_t cnt : counts) {
+    std::vector<uint8_t> mlens(cnt);
+    sha3_utils::random_data<uint8_t>(mlens);
+
+    std::vector<std::vector<uint8_t>> msgs(cnt);
+    std::vector<std::span<const uint8_t>> _msgs(cnt);
+
+    for (size_t i = 0; i < cnt; i++) {
+      msgs[i].resize(mlens[i] * 3);
+      sha3_utils::random_data<uint8_t>(msgs[i]);
+      _msgs[i] = msgs[i];
+    }
+
+    std::vector<uint8_t> mds0(cnt * sha3_384::DIGEST_LEN);
+    std::vector<uint8_t> mds1(cnt * sha3_384::DIGEST_LEN);
+
+    auto _mds0 = std::span(mds0);
+
+    for (size_t i = 0; i < cnt; i++) {
+      auto md = _mds0.subspan(i * sha3_384::DIGEST_LEN, sha3_384::DIGEST_LEN);
+      sha3_384::hash(msgs[i], md.first<sha3_384::DIGEST_LEN>());
+    }
+
+    sha3_384::hash_many(_msgs, mds1);
+
+    EXPECT_EQ(mds0, mds1) << "cnt = " << cnt;
   }
 }
 
@@ -125,6 +275,11 @@ TEST(Sha3Hashing, Sha3_384KnownAnswerTests)
 
       EXPECT_EQ(digest, md);
 
+      std::fill(digest.begin(), digest.end(), 0);
+      sha3_384::hash(msg, _digest);
+
+      EXPECT_EQ(digest, md);
+
       std::string empty_line;
       std::getline(file, empty_line);
     } else {
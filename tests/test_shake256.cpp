@@ -1,4 +1,6 @@
 #include "shake256.hpp"
+#include "shake256_many.hpp"
+#include "shake256x4.hpp"
 #include "test_conf.hpp"
 #include <algorithm>
 #include <fstream>
@@ -59,8 +61,8 @@ TEST(Sha3Xof, CompileTimeEvalShake256)
     "Must be able to compute Shake256 Xof during compile-time !");
 }
 
-// Test that absorbing same message bytes using both incremental and one-shot
-// hashing, should yield same output bytes, for SHAKE256 XOF.
+// Test that absorbing same message bytes using incremental, fragmented and
+// one-shot hashing, should yield same output bytes, for SHAKE256 XOF.
 //
 // This test collects inspiration from
 // https://github.com/itzmeanjan/turboshake/blob/e1a6b950c5374aff49f04f6d51d807e68077ab25/src/tests.rs#L372-L415
@@ -71,10 +73,12 @@ TEST(Sha3Xof, Shake256IncrementalAbsorptionAndSqueezing)
       std::vector<uint8_t> msg(mlen);
       std::vector<uint8_t> out0(olen);
       std::vector<uint8_t> out1(olen);
+      std::vector<uint8_t> out2(olen);
 
       auto _msg = std::span(msg);
       auto _out0 = std::span(out0);
       auto _out1 = std::span(out1);
+      auto _out2 = std::span(out2);
 
       sha3_utils::random_data(_msg);
 
@@ -113,10 +117,366 @@ TEST(Sha3Xof, Shake256IncrementalAbsorptionAndSqueezing)
       }
 
       EXPECT_EQ(out0, out1);
+
+      // Fragmented absorption, every fifth fragment being empty
+      std::vector<std::span<const uint8_t>> frags;
+
+      off = 0;
+      while (off < mlen) {
+        const size_t elen = (frags.size() % 5 == 4)
+                              ? 0
+                              : std::min<size_t>(msg[off] + 1, mlen - off);
+
+        frags.push_back(_msg.subspan(off, elen));
+        off += elen;
+      }
+
+      hasher.reset();
+      hasher.absorb(frags);
+      hasher.finalize();
+      hasher.squeeze(_out2);
+
+      EXPECT_EQ(out0, out2);
+    }
+  }
+}
+
+// Test that squeezing whole rate blocks, either right after finalization or
+// after squeezing a few bytes, should yield same output bytes as squeezing
+// those many bytes using byte oriented squeeze, for SHAKE256 XOF.
+TEST(Sha3Xof, Shake256SqueezeBlocks)
+{
+  constexpr size_t rbytes = shake256::RATE / 8;
+  constexpr size_t prefix_lens[]{ 0, 1, rbytes - 1, rbytes, rbytes + 7 };
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen += 31) {
+    for (const size_t plen : prefix_lens) {
+      for (size_t n = 0; n < 5; n++) {
+        const size_t olen = plen + n * rbytes;
+
+        std::vector<uint8_t> msg(mlen);
+        std::vector<uint8_t> out0(olen);
+        std::vector<uint8_t> out1(olen);
+
+        auto _out1 = std::span(out1);
+
+        sha3_utils::random_data<uint8_t>(msg);
+
+        shake256::shake256_t hasher;
+
+        hasher.absorb(msg);
+        hasher.finalize();
+        hasher.squeeze(out0);
+
+        hasher.reset();
+
+        hasher.absorb(msg);
+        hasher.finalize();
+        hasher.squeeze(_out1.first(plen));
+        hasher.squeeze_blocks(n, _out1.subspan(plen));
+
+        EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", prefix = " << plen
+                              << ", n = " << n;
+      }
     }
   }
 }
 
+// Ensure that squeezing whole rate blocks of SHAKE256 Xof refuses an output
+// buffer too short to hold all of them, instead of writing past its end.
+// Assertions are compiled out when `NDEBUG` is defined.
+TEST(Sha3Xof, Shake256SqueezeBlocksShortBufferDeathTest)
+{
+#if !defined NDEBUG
+  constexpr size_t rbytes = shake256::RATE / 8;
+
+  std::vector<uint8_t> out(2 * rbytes - 1);
+
+  shake256::shake256_t hasher;
+  hasher.finalize();
+
+  EXPECT_DEATH(hasher.squeeze_blocks(2, out), "out.size");
+#else
+  GTEST_SKIP() << "assertions are disabled";
+#endif
+}
+
+// Ensure that one-shot SHAKE256 Xof, both during compilation-time and program
+// execution, yields same output as `shake256_t`, for messages and outputs of
+// length, both shorter and longer than a single block.
+TEST(Sha3Xof, Shake256OneshotHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, 256> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, 256> md{};
+    shake256::hash(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_shake256(),
+                "Must be able to compute Shake256 Xof during compile-time !");
+
+  constexpr size_t rbytes = shake256::RATE / 8;
+  constexpr size_t olens[]{
+    0, 1, 32, rbytes - 1, rbytes, rbytes + 1, 3 * rbytes
+  };
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen++) {
+    for (const size_t olen : olens) {
+      std::vector<uint8_t> msg(mlen);
+      std::vector<uint8_t> out0(olen);
+      std::vector<uint8_t> out1(olen);
+
+      sha3_utils::random_data<uint8_t>(msg);
+
+      shake256::shake256_t hasher;
+
+      hasher.absorb(msg);
+      hasher.finalize();
+      hasher.squeeze(out0);
+
+      shake256::hash(msg, out1);
+
+      EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", olen = " << olen;
+    }
+  }
+}
+
+// Checks that SHAKE256 output of `olen` -bytes, for `mlen` -bytes message,
+// computed using one-shot hashing, specialized for given message and output
+// length, is same as the one computed using one-shot hashing, which works with
+// messages and outputs of any length.
+template<size_t olen, size_t... mlens>
+static void
+check_shake256_fixed_length_hashing()
+{
+  const auto check = []<size_t mlen>() {
+    std::array<uint8_t, mlen> msg{};
+    std::array<uint8_t, olen> out0{};
+    std::array<uint8_t, olen> out1{};
+
+    sha3_utils::random_data<uint8_t>(msg);
+
+    shake256::hash(std::span<const uint8_t>(msg), out0);
+    shake256::hash<mlen, olen>(msg, out1);
+
+    EXPECT_EQ(out0, out1) << "mlen = " << mlen << ", olen = " << olen;
+  };
+
+  (check.template operator()<mlens>(), ...);
+}
+
+// Ensure that one-shot SHAKE256 Xof, specialized for message and output length
+// known at compile-time, both during compilation-time and program execution,
+// yields same output as one-shot SHAKE256 of message and output with length
+// known at runtime.
+TEST(Sha3Xof, Shake256FixedLengthHashing)
+{
+  constexpr auto md = []() {
+    std::array<uint8_t, 256> data{};
+    std::iota(data.begin(), data.end(), 0);
+
+    std::array<uint8_t, 256> md{};
+    shake256::hash<data.size(), md.size()>(data, md);
+
+    return md;
+  }();
+
+  static_assert(md == eval_shake256(),
+                "Must be able to compute Shake256 Xof during compile-time !");
+
+  constexpr size_t rbytes = shake256::RATE / 8;
+
+  check_shake256_fixed_length_hashing<0, 0, 1, 32, rbytes, 1184>();
+  check_shake256_fixed_length_hashing<32, 0, 1, 7, 8, 9, 32, 33, 64, 1184>();
+  check_shake256_fixed_length_hashing<32, rbytes - 9, rbytes - 1, rbytes>();
+  check_shake256_fixed_length_hashing<32, rbytes + 1, 2 * rbytes + 3>();
+  check_shake256_fixed_length_hashing<rbytes, 0, 32, rbytes, rbytes + 1>();
+  check_shake256_fixed_length_hashing<rbytes + 1, 0, 32, rbytes + 1>();
+  check_shake256_fixed_length_hashing<3 * rbytes + 5, 0, 32, 1184>();
+}
+
+// Ensure that 4-way SHAKE256 Xof, absorbing four messages and squeezing four
+// output streams in lock-step, both incrementally, produces same output as
+// four SHAKE256 Xof instances.
+TEST(Sha3Xof, Shake256x4IncrementalAbsorptionAndSqueezing)
+{
+  constexpr size_t ways = 4;
+
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen += 7) {
+    for (size_t olen = MIN_OUT_LEN; olen < MAX_OUT_LEN; olen += 11) {
+      std::vector<uint8_t> msgs(mlen * ways);
+      std::vector<uint8_t> outs0(olen * ways);
+      std::vector<uint8_t> outs1(olen * ways);
+
+      auto _msgs = std::span(msgs);
+      auto _outs0 = std::span(outs0);
+      auto _outs1 = std::span(outs1);
+
+      sha3_utils::random_data<uint8_t>(msgs);
+
+      for (size_t j = 0; j < ways; j++) {
+        shake256::shake256_t hasher;
+
+        hasher.absorb(_msgs.subspan(j * mlen, mlen));
+        hasher.finalize();
+        hasher.squeeze(_outs0.subspan(j * olen, olen));
+      }
+
+      shake256::shake256x4_t hasher;
+
+      // Incremental absorption, in pieces of varying length
+      size_t off = 0;
+      while (off < mlen) {
+        const auto elen = std::min<size_t>(msgs[off] % 97 + 1, mlen - off);
+
+        hasher.absorb(_msgs.subspan(0 * mlen + off, elen),
+                      _msgs.subspan(1 * mlen + off, elen),
+                      _msgs.subspan(2 * mlen + off, elen),
+                      _msgs.subspan(3 * mlen + off, elen));
+        off += elen;
+      }
+
+      hasher.finalize();
+
+      // Incremental squeezing, in pieces of varying length
+      off = 0;
+      while (off < olen) {
+        const auto elen = std::min<size_t>(outs0[off] % 41 + 1, olen - off);
+
+        hasher.squeeze(_outs1.subspan(0 * olen + off, elen),
+                       _outs1.subspan(1 * olen + off, elen),
+                       _outs1.subspan(2 * olen + off, elen),
+                       _outs1.subspan(3 * olen + off, elen));
+        off += elen;
+      }
+
+      EXPECT_EQ(outs0, outs1) << "mlen = " << mlen << ", olen = " << olen;
+    }
+  }
+}
+
+// Checks that SHAKE256 outputs of many messages, of unequal length, computed
+// together using given batched hashing routine, are same as computing them one
+// after another.
+template<void (*hash_many)(std::span<const std::span<const uint8_t>>,
+                           std::span<uint8_t>,
+                           size_t)>
+static void
+check_shake256_hash_many()
+{
+  constexpr size_t rbytes = shake256::RATE / 8;
+
+  constexpr size_t counts[]{ 0, 1, 2, 3, 7, 8, 9, 17, 64 };
+  constexpr size_t olens[]{ 0, 32, rbytes + 1, 3 * rbytes };
+
+  for (const size_t cnt : counts) {
+    for (const size_t olen : olens) {
+      std::vector<uint8_t> mlens(cnt);
+      sha3_utils::random_data<uint8_t>(mlens);
+
+      std::vector<std::vector<uint8_t>> msgs(cnt);
+      std::vector<std::span<const uint8_t>> _msgs(cnt);
+
+      for (size_t i = 0; i < cnt; i++) {
+        msgs[i].resize(mlens[i] * 3);
+        sha3_utils::random_data<uint8_t>(msgs[i]);
+        _msgs[i] = msgs[i];
+      }
+
+      // Output buffer has spare room, which must be left untouched
+      std::vector<uint8_t> outs0(cnt * olen + 7, 0xff);
+      std::vector<uint8_t> outs1(cnt * olen + 7, 0xff);
+
+      auto _outs0 = std::span(outs0);
+
+      for (size_t i = 0; i < cnt; i++) {
+        shake256::hash(msgs[i], _outs0.subspan(i * olen, olen));
+      }
+
+      hash_many(_msgs, outs1, olen);
+
+      EXPECT_EQ(outs0, outs1) << "cnt = " << cnt << ", olen = " << olen;
+    }
+  }
+}
+
+// Same as `shake256::hash_many`, but forced to use given batched permutation,
+// so that packing of messages into lanes is exercised on any target.
+template<size_t ways, void (*permute)(uint64_t*)>
+static void
+shake256_hash_many_xN(std::span<const std::span<const uint8_t>> msgs,
+                      std::span<uint8_t> outs,
+                      const size_t olen)
+{
+  constexpr uint8_t ds = (1 << shake256::DOM_SEP_BW) | shake256::DOM_SEP;
+
+  sponge::oneshot_ragged_xN<shake256::RATE, keccak::ROUNDS, ways, permute>(
+    msgs, ds, outs, olen);
+}
+
+// Ensure that 4-way SHAKE256 Xof refuses messages or outputs of unequal
+// length, instead of reading or writing past end of shorter ones. Assertions
+// are compiled out when `NDEBUG` is defined.
+TEST(Sha3Xof, Shake256x4UnequalLengthDeathTest)
+{
+#if !defined NDEBUG
+  std::array<uint8_t, 64> buf{};
+  auto _buf = std::span(buf);
+
+  EXPECT_DEATH(
+    {
+      shake256::shake256x4_t hasher;
+      hasher.absorb(_buf, _buf, _buf.first(63), _buf);
+    },
+    "");
+
+  EXPECT_DEATH(
+    {
+      shake256::shake256x4_t hasher;
+      hasher.absorb(_buf, _buf, _buf, _buf);
+      hasher.finalize();
+      hasher.squeeze(_buf.first(32), _buf.first(31), _buf.first(32), _buf);
+    },
+    "");
+#else
+  GTEST_SKIP() << "assertions are disabled";
+#endif
+}
+
+// Ensure that SHAKE256 outputs of many messages, of unequal length, computed
+// together using batched hashing, on lanes of 2-way, 4-way or 8-way batched
+// permutation, are same as computing them one after another.
+TEST(Sha3Xof, Shake256HashMany)
+{
+  check_shake256_hash_many<shake256::hash_many>();
+  check_shake256_hash_many<
+    shake256_hash_many_xN<keccak::X4_WAYS, keccak::permute_x4_scalar>>();
+  check_shake256_hash_many<
+    shake256_hash_many_xN<keccak::X2_WAYS, keccak::permute_x2>>();
+  check_shake256_hash_many<
+    shake256_hash_many_xN<keccak::X8_WAYS, keccak::permute_x8_scalar>>();
+}
+
+// Ensure that batched SHAKE256 hashing refuses an output buffer too short to
+// hold `olen` -bytes output of all messages, instead of writing past its end.
+// Assertions are compiled out when `NDEBUG` is defined.
+TEST(Sha3Xof, Shake256HashManyShortBufferDeathTest)
+{
+#if !defined NDEBUG
+  std::array<uint8_t, 16> msg{};
+  std::vector<std::span<const uint8_t>> msgs(3, msg);
+  std::vector<uint8_t> outs(3 * 32 - 1);
+
+  EXPECT_DEATH(shake256::hash_many(msgs, outs, 32), "");
+#else
+  GTEST_SKIP() << "assertions are disabled";
+#endif
+}
+
 // Ensure that Shake256 Xof implementation is conformant with FIPS 202 standard,
 // by using KAT file generated following
 // https://gist.github.com/itzmeanjan/448f97f9c49d781a5eb3ddd6ea6e7364.
@@ -126,6 +486,7 @@ TEST(Sha3Xof, Shake256KnownAnswerTests)
 
   const std::string kat_file = "./kats/shake256.kat";
   std::fstream file(kat_file);
+  size_t kat_cnt = 0;
 
   while (true) {
     std::string len0;
@@ -156,6 +517,53 @@ TEST(Sha3Xof, Shake256KnownAnswerTests)
 
       EXPECT_EQ(squeezed, out);
 
+      std::fill(squeezed.begin(), squeezed.end(), 0);
+      shake256::hash(msg, squeezed);
+
+      EXPECT_EQ(squeezed, out);
+
+      // 4-way Xof, with KAT message fed to one of the lanes, in turn, while
+      // others are fed random messages of same length
+      std::vector<uint8_t> others(msg.size() * 3);
+      sha3_utils::random_data<uint8_t>(others);
+
+      auto _others = std::span(others);
+
+      std::array<std::span<const uint8_t>, 4> msgs{};
+      for (size_t j = 0, k = 0; j < msgs.size(); j++) {
+        if (j == kat_cnt % msgs.size()) {
+          msgs[j] = msg;
+        } else {
+          msgs[j] = _others.subspan(k * msg.size(), msg.size());
+          k++;
+        }
+      }
+
+      std::vector<uint8_t> digs(out.size() * msgs.size());
+      auto _digs = std::span(digs);
+
+      shake256::shake256x4_t hasher_x4;
+
+      hasher_x4.absorb(msgs[0], msgs[1], msgs[2], msgs[3]);
+      hasher_x4.finalize();
+      hasher_x4.squeeze(_digs.subspan(0 * out.size(), out.size()),
+                        _digs.subspan(1 * out.size(), out.size()),
+                        _digs.subspan(2 * out.size(), out.size()),
+                        _digs.subspan(3 * out.size(), out.size()));
+
+      for (size_t j = 0; j < msgs.size(); j++) {
+        shake256::hash(msgs[j], squeezed);
+
+        const auto dig = _digs.subspan(j * out.size(), out.size());
+        EXPECT_TRUE(std::ranges::equal(dig, squeezed));
+
+        if (j == kat_cnt % msgs.size()) {
+          EXPECT_TRUE(std::ranges::equal(dig, out));
+        }
+      }
+
+      kat_cnt++;
+
       std::string empty_line;
       std::getline(file, empty_line);
     } else {
@@ -0,0 +1,245 @@
+#include "test_conf.hpp"
+#include "turboshake256.hpp"
+#include <algorithm>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Eval TurboSHAKE256 Xof on statically defined input message during
+// compilation-time.
+constexpr std::array<uint8_t, 256>
+eval_turboshake256()
+{
+  // Statically defined input.
+  std::array<uint8_t, 256> data{};
+  std::iota(data.begin(), data.end(), 0);
+
+  // To be computed output.
+  std::array<uint8_t, 256> md{};
+
+  turboshake256::turboshake256_t hasher;
+  hasher.absorb(data);
+  hasher.finalize();
+  hasher.squeeze(md);
+
+  return md;
+}
+
+// Ensure that TurboSHAKE256 Xof implementation is compile-time evaluable.
+TEST(Sha3Xof, CompileTimeEvalTurboShake256)
+{
+  // Input  =
+  // 000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff
+  // Output =
+  // 2e1c8e060e12fab9d0f69f476a85832ca52590a8ac1cbc55b4ffc6d128dd10376c62c23ed88d53ec22e65f6026dc846fbbe9c23afa8e40e6f37fcfdbc77cfc64326c9d3afb5580c1eaeef1cdce48ded652ffc6d752d7293078ef60f77839620a20e2810d1c1e5ef3f8dc062798c1f9518b1294786e3d2600c779b819b37b423d3bfa4064ff58de6a0c226417dcc0405e0186c3922979c360694a412a97dba2fa89a41c6720e9dce5681e74c9a2f8eb8fa0cbc09f1cfb180a83315ea040811534eed86907f8f9f098c5d68b2385b3fac242259a1d099a14a984dfce3464cde9ecda311c041c9a44e2566475b6c781a791a88fba3d0169fcf1b27c8d82b27a34e1
+
+  constexpr auto md = eval_turboshake256();
+  static_assert(
+    md ==
+      std::array<uint8_t, 256>{
+        46,  28,  142, 6,   14,  18,  250, 185, 208, 246, 159, 71,  106, 133,
+        131, 44,  165, 37,  144, 168, 172, 28,  188, 85,  180, 255, 198, 209,
+        40,  221, 16,  55,  108, 98,  194, 62,  216, 141, 83,  236, 34,  230,
+        95,  96,  38,  220, 132, 111, 187, 233, 194, 58,  250, 142, 64,  230,
+        243, 127, 207, 219, 199, 124, 252, 100, 50,  108, 157, 58,  251, 85,
+        128, 193, 234, 238, 241, 205, 206, 72,  222, 214, 82,  255, 198, 215,
+        82,  215, 41,  48,  120, 239, 96,  247, 120, 57,  98,  10,  32,  226,
+        129, 13,  28,  30,  94,  243, 248, 220, 6,   39,  152, 193, 249, 81,
+        139, 18,  148, 120, 110, 61,  38,  0,   199, 121, 184, 25,  179, 123,
+        66,  61,  59,  250, 64,  100, 255, 88,  222, 106, 12,  34,  100, 23,
+        220, 192, 64,  94,  1,   134, 195, 146, 41,  121, 195, 96,  105, 74,
+        65,  42,  151, 219, 162, 250, 137, 164, 28,  103, 32,  233, 220, 229,
+        104, 30,  116, 201, 162, 248, 235, 143, 160, 203, 192, 159, 28,  251,
+        24,  10,  131, 49,  94,  160, 64,  129, 21,  52,  238, 216, 105, 7,
+        248, 249, 240, 152, 197, 214, 139, 35,  133, 179, 250, 194, 66,  37,
+        154, 29,  9,   154, 20,  169, 132, 223, 206, 52,  100, 205, 233, 236,
+        218, 49,  28,  4,   28,  154, 68,  226, 86,  100, 117, 182, 199, 129,
+        167, 145, 168, 143, 186, 61,  1,   105, 252, 241, 178, 124, 141, 130,
+        178, 122, 52,  225 },
+    "Must be able to compute TurboSHAKE256 Xof during compile-time !");
+}
+
+// Test that absorbing same message bytes using incremental, fragmented and
+// one-shot hashing, should yield same output bytes, for TurboSHAKE256 XOF.
+TEST(Sha3Xof, TurboShake256IncrementalAbsorptionAndSqueezing)
+{
+  for (size_t mlen = MIN_MSG_LEN; mlen < MAX_MSG_LEN; mlen++) {
+    for (size_t olen = MIN_OUT_LEN; olen < MAX_OUT_LEN; olen++) {
+      std::vector<uint8_t> msg(mlen);
+      std::vector<uint8_t> out0(olen);
+      std::vector<uint8_t> out1(olen);
+      std::vector<uint8_t> out2(olen);
+
+      auto _msg = std::span(msg);
+      auto _out0 = std::span(out0);
+      auto _out1 = std::span(out1);
+      auto _out2 = std::span(out2);
+
+      sha3_utils::random_data(_msg);
+
+      turboshake256::turboshake256_t hasher;
+
+      // Oneshot absorption and squeezing
+      hasher.absorb(_msg);
+      hasher.finalize();
+      hasher.squeeze(_out0);
+
+      hasher.reset();
+
+      // Incremental absorption and squeezing
+      size_t off = 0;
+      while (off < mlen) {
+        // because we don't want to be stuck in an infinite loop if msg[off] = 0
+        auto tmp = std::max<uint8_t>(msg[off], 1);
+        auto elen = std::min<size_t>(tmp, mlen - off);
+
+        hasher.absorb(_msg.subspan(off, elen));
+        off += elen;
+      }
+
+      hasher.finalize();
+
+      // squeeze message bytes in many iterations
+      off = 0;
+      while (off < olen) {
+        hasher.squeeze(_out1.subspan(off, 1));
+
+        auto elen = std::min<size_t>(out1[off], olen - (off + 1));
+
+        off += 1;
+        hasher.squeeze(_out1.subspan(off, elen));
+        off += elen;
+      }
+
+      EXPECT_EQ(out0, out1);
+
+      // Fragmented absorption, every fifth fragment being empty
+      std::vector<std::span<const uint8_t>> frags;
+
+      off = 0;
+      while (off < mlen) {
+        const size_t elen = (frags.size() % 5 == 4)
+                              ? 0
+                              : std::min<size_t>(msg[off] + 1, mlen - off);
+
+        frags.push_back(_msg.subspan(off, elen));
+        off += elen;
+      }
+
+      hasher.reset();
+      hasher.absorb(frags);
+      hasher.finalize();
+      hasher.squeeze(_out2);
+
+      EXPECT_EQ(out0, out2);
+    }
+  }
+}
+
+// Ensure that TurboSHAKE256 Xof output depends on domain separation byte.
+TEST(Sha3Xof, TurboShake256DomainSeparation)
+{
+  std::vector<uint8_t> msg(32);
+  std::vector<uint8_t> out0(32);
+  std::vector<uint8_t> out1(32);
+
+  sha3_utils::random_data<uint8_t>(msg);
+
+  turboshake256::turboshake256_t hasher;
+
+  hasher.absorb(msg);
+  hasher.finalize(0x1f);
+  hasher.squeeze(out0);
+
+  hasher.reset();
+  hasher.absorb(msg);
+  hasher.finalize(0x0b);
+  hasher.squeeze(out1);
+
+  EXPECT_NE(out0, out1);
+}
+
+// Ensure that finalizing TurboSHAKE256 Xof with a domain separation byte, not
+// ∈ [0x01, 0x7f], aborts the program, in every build mode.
+TEST(Sha3Xof, TurboShake256InvalidDomainSeparationDeathTest)
+{
+  turboshake256::turboshake256_t hasher;
+
+  EXPECT_DEATH(hasher.finalize(0x00), "");
+  EXPECT_DEATH(hasher.finalize(0x80), "");
+}
+
+// Ensure that finalizing an already finalized TurboSHAKE256 Xof does nothing,
+// even when it's passed a domain separation byte, not ∈ [0x01, 0x7f].
+TEST(Sha3Xof, TurboShake256RepeatedFinalizeIsNoop)
+{
+  std::vector<uint8_t> out0(32, 0);
+  std::vector<uint8_t> out1(32, 0);
+
+  turboshake256::turboshake256_t hasher;
+  hasher.finalize();
+  hasher.squeeze(out0);
+
+  hasher.reset();
+  hasher.finalize();
+  hasher.finalize(0x00);
+  hasher.finalize(0x80);
+  hasher.squeeze(out1);
+
+  EXPECT_EQ(out0, out1);
+}
+
+// Ensure that TurboSHAKE256 Xof implementation is conformant with its
+// specification, by using KAT file generated using an independent Python
+// implementation, which reproduces test vectors of
+// https://ia.cr/2023/342 and output of SHAKE256, when using 24 rounds.
+TEST(Sha3Xof, TurboShake256KnownAnswerTests)
+{
+  using namespace std::literals;
+
+  const std::string kat_file = "./kats/turboshake256.kat";
+  std::fstream file(kat_file);
+
+  while (true) {
+    std::string len0;
+
+    if (!std::getline(file, len0).eof()) {
+      std::string msg0;
+      std::string ds0;
+      std::string out0;
+
+      std::getline(file, msg0);
+      std::getline(file, ds0);
+      std::getline(file, out0);
+
+      auto msg1 = std::string_view(msg0);
+      auto ds1 = std::string_view(ds0);
+      auto out1 = std::string_view(out0);
+
+      auto msg2 = msg1.substr(msg1.find("="sv) + 2, msg1.size());
+      auto ds2 = ds1.substr(ds1.find("="sv) + 2, ds1.size());
+      auto out2 = out1.substr(out1.find("="sv) + 2, out1.size());
+
+      auto msg = sha3_utils::from_hex(msg2);
+      auto ds = sha3_utils::from_hex(ds2);
+      auto out = sha3_utils::from_hex(out2);
+
+      std::vector<uint8_t> squeezed(out.size());
+
+      turboshake256::turboshake256_t hasher;
+
+      hasher.absorb(msg);
+      hasher.finalize(ds[0]);
+      hasher.squeeze(squeezed);
+
+      EXPECT_EQ(squeezed, out);
+
+      std::string empty_line;
+      std::getline(file, empty_line);
+    } else {
+      break;
+    }
+  }
+
+  file.close();
+}